@@ -35,6 +35,11 @@
  *                * Buttons use the internal pull-ups and should be connected
  *                  directly to ground.
  *
+ *                The analog inputs are sampled in the background by
+ *                XInputAnalog, so the loop doesn't wait on the ADC. The
+ *                buttons are bound to their pins in a table and read by
+ *                XInputPins, a port at a time.
+ *
  *                These pins are designed around the Leonardo's layout. You
  *                may need to change the pin numbers if you're using a
  *                different board type
@@ -42,6 +47,8 @@
  */
 
 #include <XInput.h>
+#include <XInputAnalog.h>
+#include <XInputPins.h>
 
 // Setup
 const boolean UseLeftJoystick   = false;  // set to true to enable left joystick
@@ -85,82 +92,68 @@ const int Pin_DpadDown  = 11;
 const int Pin_DpadLeft  = 12;
 const int Pin_DpadRight = 13;
 
+// Button Bindings, using internal pull-up resistors
+const XInputPinBinding ButtonPins[] = {
+	{ Pin_ButtonA, BUTTON_A },
+	{ Pin_ButtonB, BUTTON_B },
+	{ Pin_ButtonX, BUTTON_X },
+	{ Pin_ButtonY, BUTTON_Y },
+
+	{ Pin_ButtonLB, BUTTON_LB },
+	{ Pin_ButtonRB, BUTTON_RB },
+
+	{ Pin_ButtonBack,  BUTTON_BACK },
+	{ Pin_ButtonStart, BUTTON_START },
+
+	{ Pin_ButtonL3, BUTTON_L3 },
+	{ Pin_ButtonR3, BUTTON_R3 },
+
+	{ Pin_DpadUp,    DPAD_UP },
+	{ Pin_DpadDown,  DPAD_DOWN },
+	{ Pin_DpadLeft,  DPAD_LEFT },
+	{ Pin_DpadRight, DPAD_RIGHT },
+};
+
+XInputAnalog analogInputs;  // Joysticks and analog triggers
+XINPUT_ANALOG_ISR()  // ADC interrupt for the above
+XInputPins<14> buttonInputs(ButtonPins);  // Everything else
+
 void setup() {
 	// If using buttons for the triggers, use internal pull-up resistors
 	if (UseTriggerButtons == true) {
 		pinMode(Pin_TriggerL, INPUT_PULLUP);
 		pinMode(Pin_TriggerR, INPUT_PULLUP);
 	}
-	// If using potentiometers for the triggers, set range
+	// If using potentiometers for the triggers, set range and sample them
 	else {
 		XInput.setTriggerRange(0, ADC_Max);
+		analogInputs.addTrigger(TRIGGER_LEFT, Pin_TriggerL);
+		analogInputs.addTrigger(TRIGGER_RIGHT, Pin_TriggerR);
 	}
 
-	// Set buttons as inputs, using internal pull-up resistors
-	pinMode(Pin_ButtonA, INPUT_PULLUP);
-	pinMode(Pin_ButtonB, INPUT_PULLUP);
-	pinMode(Pin_ButtonX, INPUT_PULLUP);
-	pinMode(Pin_ButtonY, INPUT_PULLUP);
-
-	pinMode(Pin_ButtonLB, INPUT_PULLUP);
-	pinMode(Pin_ButtonRB, INPUT_PULLUP);
-
-	pinMode(Pin_ButtonBack, INPUT_PULLUP);
-	pinMode(Pin_ButtonStart, INPUT_PULLUP);
-
-	pinMode(Pin_ButtonL3, INPUT_PULLUP);
-	pinMode(Pin_ButtonR3, INPUT_PULLUP);
-
-	pinMode(Pin_DpadUp, INPUT_PULLUP);
-	pinMode(Pin_DpadDown, INPUT_PULLUP);
-	pinMode(Pin_DpadLeft, INPUT_PULLUP);
-	pinMode(Pin_DpadRight, INPUT_PULLUP);
+	// White lie here... most generic joysticks are typically
+	// inverted by default. If the "Invert" variable is false
+	// then we'll take the opposite value with 'not' (!).
+	if (UseLeftJoystick == true) {
+		analogInputs.addJoystick(JOY_LEFT, Pin_LeftJoyX, Pin_LeftJoyY, false, !InvertLeftYAxis);
+	}
+	if (UseRightJoystick == true) {
+		analogInputs.addJoystick(JOY_RIGHT, Pin_RightJoyX, Pin_RightJoyY, false, !InvertRightYAxis);
+	}
 
 	XInput.setJoystickRange(0, ADC_Max);  // Set joystick range to the ADC
 	XInput.setAutoSend(false);  // Wait for all controls before sending
 
 	XInput.begin();
+	buttonInputs.begin();  // Set the button pin modes
+	analogInputs.begin();  // Start sampling the analog inputs
 }
 
 void loop() {
-	// Read pin values and store in variables
-	// (Note the "!" to invert the state, because LOW = pressed)
-	boolean buttonA = !digitalRead(Pin_ButtonA);
-	boolean buttonB = !digitalRead(Pin_ButtonB);
-	boolean buttonX = !digitalRead(Pin_ButtonX);
-	boolean buttonY = !digitalRead(Pin_ButtonY);
-
-	boolean buttonLB = !digitalRead(Pin_ButtonLB);
-	boolean buttonRB = !digitalRead(Pin_ButtonRB);
-
-	boolean buttonBack  = !digitalRead(Pin_ButtonBack);
-	boolean buttonStart = !digitalRead(Pin_ButtonStart);
-
-	boolean buttonL3 = !digitalRead(Pin_ButtonL3);
-	boolean buttonR3 = !digitalRead(Pin_ButtonR3);
-
-	boolean dpadUp    = !digitalRead(Pin_DpadUp);
-	boolean dpadDown  = !digitalRead(Pin_DpadDown);
-	boolean dpadLeft  = !digitalRead(Pin_DpadLeft);
-	boolean dpadRight = !digitalRead(Pin_DpadRight);
-
-	// Set XInput buttons
-	XInput.setButton(BUTTON_A, buttonA);
-	XInput.setButton(BUTTON_B, buttonB);
-	XInput.setButton(BUTTON_X, buttonX);
-	XInput.setButton(BUTTON_Y, buttonY);
-
-	XInput.setButton(BUTTON_LB, buttonLB);
-	XInput.setButton(BUTTON_RB, buttonRB);
-
-	XInput.setButton(BUTTON_BACK, buttonBack);
-	XInput.setButton(BUTTON_START, buttonStart);
-
-	XInput.setButton(BUTTON_L3, buttonL3);
-	XInput.setButton(BUTTON_R3, buttonR3);
-
-	// Set XInput DPAD values
-	XInput.setDpad(dpadUp, dpadDown, dpadLeft, dpadRight);
+	// Read the button pins and set the buttons and D-pad
+	// (the pins are LOW when pressed, the table handles that,
+	// and opposing D-pad directions are cleaned like setDpad())
+	buttonInputs.update();
 
 	// Set XInput trigger values
 	if (UseTriggerButtons == true) {
@@ -172,40 +165,9 @@ void loop() {
 		XInput.setButton(TRIGGER_LEFT, triggerLeft);
 		XInput.setButton(TRIGGER_RIGHT, triggerRight);
 	}
-	else {
-		// Read trigger potentiometer values
-		int triggerLeft  = analogRead(Pin_TriggerL);
-		int triggerRight = analogRead(Pin_TriggerR);
-
-		// Set the trigger values as analog
-		XInput.setTrigger(TRIGGER_LEFT, triggerLeft);
-		XInput.setTrigger(TRIGGER_RIGHT, triggerRight);
-	}
 
-	// Set left joystick
-	if (UseLeftJoystick == true) {
-		int leftJoyX = analogRead(Pin_LeftJoyX);
-		int leftJoyY = analogRead(Pin_LeftJoyY);
-
-		// White lie here... most generic joysticks are typically
-		// inverted by default. If the "Invert" variable is false
-		// then we'll take the opposite value with 'not' (!).
-		boolean invert = !InvertLeftYAxis;
-
-		XInput.setJoystickX(JOY_LEFT, leftJoyX);
-		XInput.setJoystickY(JOY_LEFT, leftJoyY, invert);
-	}
-
-	// Set right joystick
-	if (UseRightJoystick == true) {
-		int rightJoyX = analogRead(Pin_RightJoyX);
-		int rightJoyY = analogRead(Pin_RightJoyY);
-
-		boolean invert = !InvertRightYAxis;
-
-		XInput.setJoystickX(JOY_RIGHT, rightJoyX);
-		XInput.setJoystickY(JOY_RIGHT, rightJoyY, invert);
-	}
+	// Set the analog triggers and joysticks from the latest samples
+	analogInputs.update();
 
 	// Send control data to the computer
 	XInput.send();
@@ -0,0 +1,79 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      InterruptButtons
+ *  Description:  Reads the face buttons from pin interrupts, for the lowest
+ *                latency from a press to the host. A press is sent straight
+ *                from the interrupt if the USB endpoint is free, rather than
+ *                waiting for the loop to come around.
+ *
+ *                On the Leonardo only pins 0, 1, 2, 3 and 7 have external
+ *                interrupts, so they're used for the buttons that matter
+ *                most. The D-pad pins don't have one and are read in the
+ *                loop instead. Buttons use the internal pull-ups and
+ *                should be connected directly to ground.
+ *
+ *                Set XINPUT_INTERRUPT_BUTTONS to 1 in XInputConfig.h to
+ *                build the library with interrupt button support.
+ */
+
+#include <XInput.h>
+#include <XInputInterruptButtons.h>
+
+#if XINPUT_INTERRUPT_BUTTONS
+
+XInputInterruptButtons buttons;
+
+void setup() {
+	// Interrupt pins
+	buttons.add(BUTTON_A, 0);
+	buttons.add(BUTTON_B, 1);
+	buttons.add(BUTTON_X, 2);
+	buttons.add(BUTTON_Y, 3);
+	buttons.add(BUTTON_RB, 7);
+
+	// Polled pins
+	buttons.add(DPAD_UP, 10);
+	buttons.add(DPAD_DOWN, 11);
+	buttons.add(DPAD_LEFT, 12);
+	buttons.add(DPAD_RIGHT, 13);
+
+	buttons.setResendInterval(1000);  // At most one send per ms from the interrupts
+
+	XInput.setAutoSend(false);  // Sent from the loop or the interrupts
+	XInput.begin();
+	buttons.begin();
+}
+
+void loop() {
+	buttons.update();  // Reads the polled pins
+	XInput.send();
+	XInput.update();
+}
+
+#else
+#warning "XInputInterruptButtons is disabled, set XINPUT_INTERRUPT_BUTTONS to 1 in XInputConfig.h"
+void setup() {}
+void loop() {}
+#endif
@@ -0,0 +1,53 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      PlayerLEDs
+ *  Description:  Shows the player number LEDs sent by the host on four
+ *                LEDs, like the ring of light on an Xbox 360 controller.
+ *                Every pattern is shown, including the flashing and
+ *                rotating ones, without stopping the loop.
+ *
+ *                Lay the LEDs out as 1 top left, 2 top right, 3 bottom
+ *                left, 4 bottom right. Each needs a current limiting
+ *                resistor.
+ */
+
+#include <XInput.h>
+#include <XInputLEDs.h>
+
+XInputLEDs playerLEDs(2, 3, 4, 5);  // LEDs 1 to 4
+
+const uint8_t Pin_ButtonA = 6;
+
+void setup() {
+	pinMode(Pin_ButtonA, INPUT_PULLUP);
+
+	XInput.begin();
+	playerLEDs.begin();
+}
+
+void loop() {
+	XInput.setButton(BUTTON_A, !digitalRead(Pin_ButtonA));
+	playerLEDs.update();  // Never waits, so the buttons are read on every loop
+}
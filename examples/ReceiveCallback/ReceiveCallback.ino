@@ -27,6 +27,8 @@
  *                data when the device receives a new USB packet from the host.
  *
  *  WARNING: The callback is called from within the USB ISR. Keep it short!
+ *           Or, call 'XInput.setDeferredReceive(true)' and 'XInput.update()'
+ *           in the loop to run the callback from the loop instead.
  *
  */
 
@@ -0,0 +1,85 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      RecordReplay
+ *  Description:  Records the buttons pressed on three pins, then plays
+ *                them back at the same timing. Hold the record pin low
+ *                to record, then pull the play pin low to replay. Each
+ *                recording plays once.
+ *
+ *                The recording is kept in RAM and only stores the changes
+ *                between frames, so a few hundred bytes holds a lot of
+ *                button presses.
+ */
+
+#include <XInput.h>
+#include <XInputRecorder.h>
+
+const uint8_t Pin_Record = 2;
+const uint8_t Pin_Play = 3;
+const uint8_t Pin_ButtonA = 4;
+const uint8_t Pin_ButtonB = 5;
+const uint8_t Pin_ButtonX = 6;
+
+uint8_t recordBuffer[512];
+XInputRecorder recorder(recordBuffer, sizeof(recordBuffer));
+XInputPlayer player(recorder);  // Plays straight from the recorder's buffer
+
+void setup() {
+	pinMode(Pin_Record, INPUT_PULLUP);
+	pinMode(Pin_Play, INPUT_PULLUP);
+	pinMode(Pin_ButtonA, INPUT_PULLUP);
+	pinMode(Pin_ButtonB, INPUT_PULLUP);
+	pinMode(Pin_ButtonX, INPUT_PULLUP);
+
+	XInput.begin();
+}
+
+void loop() {
+	const boolean recordPressed = !digitalRead(Pin_Record);
+	const boolean playPressed = !digitalRead(Pin_Play);
+
+	if (recordPressed && !recorder.recording()) {
+		player.stop();
+		recorder.clear();  // Replace the old recording
+		recorder.begin();
+	}
+	else if (!recordPressed && recorder.recording()) {
+		recorder.end();
+	}
+
+	if (playPressed && !recorder.recording() && !player.playing()) {
+		XInput.releaseAll();
+		player.begin();
+	}
+
+	if (player.playing()) {
+		player.update();  // Sets the controls from the recording
+	}
+	else {
+		XInput.setButton(BUTTON_A, !digitalRead(Pin_ButtonA));
+		XInput.setButton(BUTTON_B, !digitalRead(Pin_ButtonB));
+		XInput.setButton(BUTTON_X, !digitalRead(Pin_ButtonX));
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      RumbleMotors
+ *  Description:  Drives two vibration motors from the rumble data sent by
+ *                the host. The motors need a transistor or motor driver on
+ *                each PWM pin, they can't be powered from the pins directly.
+ *
+ *                The outputs are updated as soon as a rumble packet
+ *                arrives, so the loop can be as slow as it needs to be.
+ *                Build with XINPUT_RUMBLE_TIMER set to 1 to render the
+ *                ramps and kick-start pulses from a hardware timer too.
+ */
+
+#include <XInput.h>
+#include <XInputRumble.h>
+
+const uint8_t Pin_MotorLarge = 9;   // Left grip, PWM
+const uint8_t Pin_MotorSmall = 10;  // Right grip, PWM
+
+XInputRumble rumbleOutput(Pin_MotorLarge, Pin_MotorSmall);
+
+void setup() {
+	rumbleOutput.setMinimum(60);  // Motors stall below this PWM level
+	rumbleOutput.setRamp(4);  // Change by at most 4 levels per ms
+	rumbleOutput.setKick(255, 20);  // Full power for 20 ms when starting
+
+	XInput.begin();
+	rumbleOutput.begin();
+}
+
+void loop() {
+	XInput.update();  // Renders the rumble ramps, if not using the timer
+}
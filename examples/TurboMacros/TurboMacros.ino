@@ -0,0 +1,80 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      TurboMacros
+ *  Description:  Turbo fire on the A button, and a button that plays a
+ *                short macro. Both run on the library's 1 ms tick, and
+ *                each press and release is held until it has been sent,
+ *                so the host sees every one however fast the turbo.
+ *
+ *                Buttons use the internal pull-ups and should be
+ *                connected directly to ground.
+ */
+
+#include <XInput.h>
+#include <XInputMacros.h>
+
+const int Pin_ButtonA = 2;  // Turbo
+const int Pin_Macro   = 3;  // Plays the macro
+
+const uint8_t TurboRate = 20;  // Presses per second
+
+// Quarter circle forward, then punch
+const XInputMacroStep Fireball[] = {
+	{ DPAD_DOWN, true, 30 },
+	{ DPAD_RIGHT, true, 30 },
+	{ DPAD_DOWN, false, 30 },
+	{ DPAD_RIGHT, false, 0 },
+	{ BUTTON_X, true, 50 },
+	{ BUTTON_X, false, 0 },
+};
+
+XInputMacros<2> macros;
+
+boolean macroLast = false;
+
+void setup() {
+	pinMode(Pin_ButtonA, INPUT_PULLUP);
+	pinMode(Pin_Macro, INPUT_PULLUP);
+
+	XInput.setAutoSend(false);  // Sent once per loop
+	XInput.begin();
+
+	macros.setTurbo(BUTTON_A, TurboRate);
+	macros.begin();
+}
+
+void loop() {
+	macros.setButton(BUTTON_A, !digitalRead(Pin_ButtonA));  // Turbo while held
+
+	boolean macroButton = !digitalRead(Pin_Macro);
+	if (macroButton && !macroLast) {
+		macros.play(Fireball);  // Once per press
+	}
+	macroLast = macroButton;
+
+	macros.update();  // Runs the ticks due
+	XInput.send();
+	XInput.update();
+}
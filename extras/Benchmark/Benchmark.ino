@@ -0,0 +1,239 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      Benchmark
+ *  Description:  Measures the time taken by the library's control surface
+ *                functions on the target board, both per call and for a
+ *                typical frame of 18 calls followed by a send. Useful for
+ *                catching regressions in the library's hot paths before
+ *                they show up as lost loop time.
+ *
+ *                Results are printed in microseconds. Each measurement is
+ *                averaged over 'Iterations' calls, with the overhead of the
+ *                timing loop itself subtracted.
+ *
+ *                When the board is running in XInput mode the native USB
+ *                serial port is unavailable, so the results are printed
+ *                to the first hardware serial port instead.
+ *
+ *                The sketch also builds with the host simulator, in place
+ *                of its workload, to compare changes without a board:
+ *
+ *                  cd extras/HostSimulator
+ *                  c++ -std=gnu++11 -O2 -I. -I../../src -o xinput_bench \
+ *                    -x c++ ../Benchmark/Benchmark.ino -x none \
+ *                    XInputSim.cpp ../../src/[A-Z]*.cpp
+ *                  ./xinput_bench -d 1
+ *
+ *                On the host the times come from the host's clock, over
+ *                more iterations.
+ */
+
+#include <XInput.h>
+
+#if defined(XInputSim_h)  // Host simulator
+#define BenchmarkOutput Serial
+#elif defined(USB_XINPUT)
+#define BenchmarkOutput Serial1
+#else
+#define BenchmarkOutput Serial
+#endif
+
+const unsigned long BaudRate = 115200;
+
+#ifdef XInputSim_h
+const unsigned int Iterations = 100000;
+const int Decimals = 4;  // Calls take ns on the host
+#else
+const unsigned int Iterations = 1000;
+const int Decimals = 2;
+#endif
+
+// 'volatile' so the compiler can't fold the inputs away
+volatile int32_t analogInput = 0;
+volatile boolean buttonInput = false;
+
+float loopOverhead = 0.0;  // us per iteration, measured at startup
+
+// Declared ahead for builds outside of the IDE, which doesn't add them
+float benchmark(void(*function)(), unsigned int count = Iterations);
+float benchmarkRanged(void(*function)(), unsigned int count = Iterations);
+float timeLoop(void(*function)(), unsigned int count);
+void printResult(const __FlashStringHelper* name, float time);
+void emptyCall();
+void callSetButton();
+void callSetButtonSame();
+void callSetTrigger();
+void callSetJoystick();
+void callSetJoystickMap();
+void callSetDpad();
+void callReleaseAll();
+void callFrame();
+void callSend();
+
+void setup() {
+	BenchmarkOutput.begin(BaudRate);
+	while (!BenchmarkOutput) {}  // wait for native USB serial, if present
+
+	XInput.setAutoSend(false);  // Measure the setters, not the USB bus
+	XInput.begin();
+
+	loopOverhead = timeLoop(emptyCall, Iterations);
+}
+
+void loop() {
+	BenchmarkOutput.println(F("XInput Benchmark (us, averaged)"));
+	BenchmarkOutput.println(F("-------------------------------"));
+
+	// Per-call timings
+	printResult(F("setButton"), benchmark(callSetButton));
+	printResult(F("setButton (no change)"), benchmark(callSetButtonSame));
+	printResult(F("setTrigger"), benchmark(callSetTrigger));
+	printResult(F("setTrigger (ranged)"), benchmarkRanged(callSetTrigger));
+	printResult(F("setJoystick"), benchmark(callSetJoystick));
+	printResult(F("setJoystick (ranged)"), benchmarkRanged(callSetJoystick));
+	printResult(F("setDpad"), benchmark(callSetDpad));
+	printResult(F("releaseAll"), benchmark(callReleaseAll));
+
+	// Rescaling a 10-bit ADC reading to the joystick range, both axes.
+	// The sketch calling map() before setJoystick() vs the range set by
+	// setJoystickRange(). The library still rescales the default range
+	// in the first, so compare the raw timings rather than subtracting.
+	printResult(F("setJoystick, map()"), benchmark(callSetJoystickMap));
+	printResult(F("setJoystick, setJoystickRange()"), benchmarkRanged(callSetJoystick));
+
+	// A full frame of inputs, as a typical gamepad sketch would
+	// run them once per loop. The send is measured separately
+	// since it depends on the USB bus (or debug output) speed.
+	printResult(F("frame (18 calls)"), benchmark(callFrame));
+	printResult(F("send"), benchmark(callSend, 20));
+
+	BenchmarkOutput.println();
+	delay(5000);
+}
+
+float benchmark(void(*function)(), unsigned int count) {
+	XInput.reset();
+	XInput.setAutoSend(false);
+	return timeLoop(function, count) - loopOverhead;
+}
+
+float benchmarkRanged(void(*function)(), unsigned int count) {
+	XInput.reset();
+	XInput.setAutoSend(false);
+#if XINPUT_INPUT_RANGES
+	XInput.setTriggerRange(0, 1023);  // 10-bit ADC
+	XInput.setJoystickRange(0, 1023);
+#endif
+	return timeLoop(function, count) - loopOverhead;
+}
+
+float timeLoop(void(*function)(), unsigned int count) {
+#ifdef XInputSim_h
+	const double start = XInputSim::hostMicros();  // The virtual clock stands still
+#else
+	const unsigned long start = micros();
+#endif
+	for (unsigned int i = 0; i < count; i++) {
+		analogInput = i & 0x3FF;
+		buttonInput = i & 0x01;
+		function();
+	}
+#ifdef XInputSim_h
+	const double stop = XInputSim::hostMicros();
+#else
+	const unsigned long stop = micros();
+#endif
+	return (float) (stop - start) / count;
+}
+
+void printResult(const __FlashStringHelper* name, float time) {
+	BenchmarkOutput.print(name);
+	BenchmarkOutput.print(F(": "));
+	BenchmarkOutput.println(time, Decimals);
+}
+
+void emptyCall() {}
+
+void callSetButton() {
+	XInput.setButton(BUTTON_A, buttonInput);
+}
+
+void callSetButtonSame() {
+	XInput.setButton(BUTTON_A, false);
+}
+
+void callSetTrigger() {
+	XInput.setTrigger(TRIGGER_LEFT, analogInput);
+}
+
+void callSetJoystick() {
+	XInput.setJoystick(JOY_LEFT, analogInput, analogInput);
+}
+
+void callSetJoystickMap() {
+	const int32_t value = map(analogInput, 0, 1023, -32768, 32767);
+	XInput.setJoystick(JOY_LEFT, value, value);
+}
+
+void callSetDpad() {
+	const boolean state = buttonInput;
+	XInput.setDpad(state, !state, state, !state);
+}
+
+void callReleaseAll() {
+	XInput.releaseAll();
+}
+
+void callFrame() {
+	const boolean state = buttonInput;
+	const int32_t value = analogInput;
+
+	XInput.setButton(BUTTON_A, state);
+	XInput.setButton(BUTTON_B, state);
+	XInput.setButton(BUTTON_X, state);
+	XInput.setButton(BUTTON_Y, state);
+	XInput.setButton(BUTTON_LB, state);
+	XInput.setButton(BUTTON_RB, state);
+	XInput.setButton(BUTTON_BACK, state);
+	XInput.setButton(BUTTON_START, state);
+	XInput.setButton(BUTTON_L3, state);
+	XInput.setButton(BUTTON_R3, state);
+	XInput.setButton(BUTTON_LOGO, state);
+
+	XInput.setDpad(state, !state, state, !state);
+
+	XInput.setTrigger(TRIGGER_LEFT, value);
+	XInput.setTrigger(TRIGGER_RIGHT, value);
+
+	XInput.setJoystickX(JOY_LEFT, value);
+	XInput.setJoystickY(JOY_LEFT, value);
+	XInput.setJoystickX(JOY_RIGHT, value);
+	XInput.setJoystickY(JOY_RIGHT, value);
+}
+
+void callSend() {
+	XInput.setButton(BUTTON_A, buttonInput);  // Force new data
+	XInput.send();
+}
@@ -0,0 +1,161 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Simulator, Arduino API
+ *
+ *  The parts of the Arduino API used by the library and the simulated
+ *  sketch, for building on a Linux host. Time comes from the simulator's
+ *  virtual clock, see XInputSim.h.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define LED_BUILTIN 13
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Strings aren't moved to flash, F() only changes the type
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(string))
+#define PROGMEM
+
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// Time, from the simulator's virtual clock
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Interrupts only run at calls into the simulator, so these are no-ops
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+// Pins, stored by the simulator
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+int analogRead(uint8_t pin);
+
+// Pin interrupts, run by XInputSim::setPin() when a pin changes. Every
+// pin has one
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+
+// Random numbers, from the simulator's seed
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class Print {
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t * buffer, size_t size);
+
+	size_t print(const char * str);
+	size_t print(const __FlashStringHelper * str);
+	size_t print(char c);
+	size_t print(unsigned char n, int base=DEC);
+	size_t print(int n, int base=DEC);
+	size_t print(unsigned int n, int base=DEC);
+	size_t print(long n, int base=DEC);
+	size_t print(unsigned long n, int base=DEC);
+	size_t print(double n, int digits=2);
+
+	size_t println();
+	template<typename T> size_t println(T val) { return print(val) + println(); }
+	template<typename T> size_t println(T val, int format) { return print(val, format) + println(); }
+
+private:
+	size_t printNumber(unsigned long n, int base, boolean negative);
+};
+
+class Stream : public Print {
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+
+	void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+	size_t readBytes(uint8_t * buffer, size_t length);  // No waiting, the simulation is single threaded
+
+protected:
+	unsigned long timeout = 1000;
+};
+
+// Serial, written to stdout
+class HostSerial : public Stream {
+public:
+	void begin(unsigned long baud) { (void) baud; }
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t * buffer, size_t size) override;
+	using Print::write;
+	int available() override { return 0; }
+	int read() override { return -1; }
+	int peek() override { return -1; }
+	explicit operator bool() { return true; }
+};
+extern HostSerial Serial;
+
+// Sketch
+void setup();
+void loop();
+
+// The simulated XInput backend, as a board core would provide
+#include "XInputSim.h"
+
+#endif
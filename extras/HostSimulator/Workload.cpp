@@ -0,0 +1,95 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Simulator, Workload
+ *
+ *  The sketch run by the simulator. A random control changes every
+ *  'inputInterval', marked for the latency report when it changes. It's
+ *  set right away in the blocking and async modes, and in the sample
+ *  callback in the poll synced mode, as a sketch reading real inputs
+ *  would.
+ */
+
+#include <Arduino.h>
+#include <XInput.h>
+
+static const XInputControl Buttons[] = {
+	BUTTON_A, BUTTON_B, BUTTON_X, BUTTON_Y, BUTTON_LB, BUTTON_RB,
+	DPAD_UP, DPAD_DOWN, DPAD_LEFT, DPAD_RIGHT,
+};
+
+static uint32_t lastInput = 0;
+static boolean inputPending = false;
+
+static void changeInput() {
+	const long choice = random(4);
+	if (choice == 0) {
+		const XInputControl trigger = random(2) ? TRIGGER_LEFT : TRIGGER_RIGHT;
+		XInput.setTrigger(trigger, (XInput.getTrigger(trigger) + random(1, 256)) % 256);  // Always a change
+	}
+	else if (choice == 1) {
+		XInput.setJoystick(random(2) ? JOY_LEFT : JOY_RIGHT, random(-32768, 32768), random(-32768, 32768));
+	}
+	else {
+		const XInputControl button = Buttons[random(sizeof(Buttons) / sizeof(Buttons[0]))];
+		XInput.setButton(button, !XInput.getButton(button));  // Always a change
+	}
+}
+
+static void sampleInputs() {
+	if (!inputPending) return;
+	inputPending = false;
+	changeInput();
+}
+
+void setup() {
+	switch (XInputSim::getConfig().mode) {
+	case XInputSimMode::Blocking:
+		break;
+	case XInputSimMode::Async:
+		XInput.setAsyncSend(true);
+		break;
+	case XInputSimMode::PollSync:
+		XInput.setPollSync(true);
+		XInput.setSampleCallback(sampleInputs, XInputSim::getConfig().leadTime);
+		break;
+	}
+
+	XInput.begin();
+	lastInput = micros();
+}
+
+void loop() {
+	const uint32_t now = micros();
+	if (now - lastInput >= XInputSim::getConfig().inputInterval) {
+		lastInput = now;
+		XInputSim::markInput();  // Input changes now, the sketch may see it later
+		inputPending = true;
+	}
+	if (XInputSim::getConfig().mode != XInputSimMode::PollSync) {
+		sampleInputs();
+	}
+
+	XInput.update();
+}
@@ -0,0 +1,681 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Simulator
+ *
+ *  Runs the library and a sketch against a simulated USB host, and
+ *  reports the bus traffic and the latency from input to host.
+ *
+ *  Build:  c++ -std=gnu++11 -O2 -Wno-cpp -I. -I../../src -o xinput_sim \
+ *              XInputSim.cpp Workload.cpp ../../src/[A-Z]*.cpp
+ *
+ *  Usage:  xinput_sim [options]
+ *
+ *    -p us     Host poll interval (1000)
+ *    -k n      IN endpoint banks, 1-8 (1)
+ *    -s us     Time send() takes to copy a packet (20)
+ *    -n ppt    Polls NAKed with data waiting, per 1000 (0)
+ *    -e ppt    send() calls that fail with -1, per 1000 (0)
+ *    -r us     Time between rumble packets from the host, 0 for none (0)
+ *    -l us     Time between LED packets from the host, 0 for none (0)
+ *    -t us     Time taken by each loop() (100)
+ *    -i us     Time between input changes, for the sketch (5000)
+ *    -m mode   Send mode for the sketch: blocking, async or pollsync
+ *    -a us     Sample lead time for the sketch, in pollsync mode (200)
+ *    -d s      Length of the run, in seconds of simulated time (10)
+ *    -S seed   Random seed (1)
+ *    -o path   Write the frames the host reads to a file or FIFO
+ *    -u path   Write the frames the host reads to a UNIX socket
+ *
+ *  Frames are written in the telemetry format (see 'XInputTelemetry' in
+ *  src/XInput.h), with the host's read time as the timestamp, so they can
+ *  be read with 'extras/TelemetryDecoder':
+ *
+ *    mkfifo /tmp/xinput && xinput_telemetry /tmp/xinput &
+ *    xinput_sim -o /tmp/xinput
+ *
+ *  The sketch is Workload.cpp. Any other sketch can be built in its place,
+ *  as long as it calls XInputSim::markInput() before the changes it wants
+ *  the latency of.
+ */
+
+#include "Arduino.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+// --------------------------------------------------------
+// Simulator State                                        |
+// --------------------------------------------------------
+
+struct SimFrame {
+	uint8_t data[20];
+	uint64_t submitTime;  // Time send() queued the frame
+	uint64_t markTime;  // Time of the input that changed it
+	boolean marked;  // 'markTime' is valid
+};
+
+static constexpr uint8_t MaxBanks = 8;
+
+static XInputSimConfig Config;
+static uint64_t SimTime = 0;
+static boolean InInterrupt = false;  // Running a simulated interrupt, the clock is stopped
+static uint32_t RandomState = 1;
+
+static SimFrame Banks[MaxBanks];  // IN endpoint, ring buffer
+static uint8_t BankHead = 0;
+static uint8_t BankCount = 0;
+
+static uint8_t OutBuffer[8];  // OUT endpoint
+static uint8_t OutLength = 0;
+
+static void (*RecvCallback)(void) = nullptr;
+static void (*PollCallback)(void) = nullptr;
+
+static uint64_t NextPoll;
+static uint64_t NextRumble;
+static uint64_t NextLED;
+
+static boolean MarkPending = false;
+static uint64_t MarkTime;
+
+static int OutputFd = -1;
+static uint16_t OutputSequence = 0;
+
+static int Pins[256];
+static struct { void (*isr)(void); int mode; } PinInterrupts[256];
+
+static struct {
+	uint64_t polls;  // Host IN polls
+	uint64_t emptyPolls;  // Polls with no data waiting
+	uint64_t naks;  // Polls NAKed with data waiting
+	uint64_t frames;  // Frames read by the host
+	uint64_t sends;  // Calls to send()
+	uint64_t sendErrors;  // send() calls failed on purpose
+	uint64_t sendTimeouts;  // send() calls failed with the banks full
+	uint64_t blockedTime;  // Time send() spent waiting for a bank
+	uint64_t rumblePackets;  // OUT packets delivered
+	uint64_t ledPackets;
+	uint64_t outNaks;  // OUT packets refused, with the last one unread
+	std::vector<uint32_t> latency;  // Marked input to host read
+	std::vector<uint32_t> queueTime;  // send() to host read
+} Stats;
+
+static boolean chance(uint16_t perThousand) {
+	return perThousand != 0 && XInputSim::random() % 1000 < perThousand;
+}
+
+// --------------------------------------------------------
+// Simulated Host                                         |
+// --------------------------------------------------------
+
+static void writeFrame(const SimFrame & f) {
+	if (OutputFd < 0) return;
+
+	// Telemetry frame layout, see 'XInputTelemetry' in src/XInput.h
+	const uint32_t time = SimTime;
+	uint8_t frame[30];
+	frame[0] = 0xA5;
+	frame[1] = 0x5A;
+	frame[2] = 26;
+	frame[3] = lowByte(OutputSequence);
+	frame[4] = highByte(OutputSequence);
+	frame[5] = time;
+	frame[6] = time >> 8;
+	frame[7] = time >> 16;
+	frame[8] = time >> 24;
+	memcpy(frame + 9, f.data, sizeof(f.data));
+
+	uint8_t checksum = 0;
+	for (uint8_t i = 2; i < sizeof(frame) - 1; i++) {
+		checksum ^= frame[i];
+	}
+	frame[sizeof(frame) - 1] = checksum;
+	OutputSequence++;
+
+	size_t written = 0;
+	while (written < sizeof(frame)) {
+		const ssize_t n = write(OutputFd, frame + written, sizeof(frame) - written);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) {
+			fprintf(stderr, "Output closed: %s\n", strerror(errno));
+			close(OutputFd);
+			OutputFd = -1;
+			return;
+		}
+		written += n;
+	}
+}
+
+static void hostPoll() {
+	Stats.polls++;
+	if (BankCount == 0) {
+		Stats.emptyPolls++;  // Device NAKs, nothing to send
+		return;
+	}
+	if (chance(Config.nakRate)) {
+		Stats.naks++;  // Endpoint busy, host tries again next interval
+		return;
+	}
+
+	const SimFrame & f = Banks[BankHead];
+	BankHead = (BankHead + 1) % MaxBanks;
+	BankCount--;
+
+	Stats.frames++;
+	Stats.queueTime.push_back(SimTime - f.submitTime);
+	if (f.marked) Stats.latency.push_back(SimTime - f.markTime);
+	writeFrame(f);
+
+	if (PollCallback != nullptr) PollCallback();  // IN transfer complete
+}
+
+// Returns 'false' if the device hasn't read the last packet yet
+static boolean hostOut(const uint8_t * packet, uint8_t length) {
+	if (OutLength != 0) {
+		Stats.outNaks++;
+		return false;
+	}
+
+	memcpy(OutBuffer, packet, length);
+	OutLength = length;
+	if (RecvCallback != nullptr) RecvCallback();
+	return true;
+}
+
+static void hostRumble() {
+	const uint8_t packet[8] = { 0x00, 0x08, 0x00,
+		(uint8_t) XInputSim::random(), (uint8_t) XInputSim::random(), 0x00, 0x00, 0x00 };
+	if (hostOut(packet, sizeof(packet))) {
+		Stats.rumblePackets++;
+		NextRumble += Config.rumbleInterval;
+	}
+	else {
+		NextRumble += Config.pollInterval;  // Retry
+	}
+}
+
+static void hostLED() {
+	const uint8_t packet[3] = { 0x01, 0x03, (uint8_t) (XInputSim::random() % 0x0E) };
+	if (hostOut(packet, sizeof(packet))) {
+		Stats.ledPackets++;
+		NextLED += Config.ledInterval;
+	}
+	else {
+		NextLED += Config.pollInterval;  // Retry
+	}
+}
+
+// Runs the interrupts due up to 'until', in time order
+static void runUntil(uint64_t until) {
+	while (true) {
+		uint64_t next = NextPoll;
+		uint8_t event = 0;
+		if (Config.rumbleInterval != 0 && NextRumble < next) { next = NextRumble; event = 1; }
+		if (Config.ledInterval != 0 && NextLED < next) { next = NextLED; event = 2; }
+		if (next > until) break;
+
+		SimTime = next;
+		InInterrupt = true;
+		switch (event) {
+		case 0:
+			hostPoll();
+			NextPoll += Config.pollInterval;
+			break;
+		case 1:
+			hostRumble();
+			break;
+		case 2:
+			hostLED();
+			break;
+		}
+		InInterrupt = false;
+	}
+	if (until > SimTime) SimTime = until;
+}
+
+static uint64_t nextEvent() {
+	uint64_t next = NextPoll;
+	if (Config.rumbleInterval != 0) next = std::min(next, NextRumble);
+	if (Config.ledInterval != 0) next = std::min(next, NextLED);
+	return next;
+}
+
+// --------------------------------------------------------
+// XInputUSB Backend API                                  |
+// --------------------------------------------------------
+
+boolean XInputUSB::connected(void) {
+	return true;
+}
+
+uint8_t XInputUSB::available(void) {
+	return OutLength;
+}
+
+int XInputUSB::send(const void * buffer, uint8_t nbytes) {
+	Stats.sends++;
+	if (nbytes > sizeof(SimFrame::data)) return -1;  // Error: Too large for the endpoint
+	if (chance(Config.errorRate)) {
+		Stats.sendErrors++;
+		return -1;
+	}
+
+	// Blocks until a bank is free, like the real backends
+	const uint64_t start = SimTime;
+	while (BankCount >= Config.banks) {
+		const uint64_t deadline = start + Config.sendTimeout;
+		if (InInterrupt || SimTime >= deadline) {
+			Stats.sendTimeouts++;
+			return -1;
+		}
+		runUntil(std::min(nextEvent(), deadline));
+	}
+	Stats.blockedTime += SimTime - start;
+	XInputSim::advance(Config.sendTime);
+
+	SimFrame & f = Banks[(BankHead + BankCount) % MaxBanks];
+	memset(f.data, 0x00, sizeof(f.data));
+	memcpy(f.data, buffer, nbytes);
+	f.submitTime = SimTime;
+	f.marked = MarkPending;
+	f.markTime = MarkTime;
+	MarkPending = false;
+	BankCount++;
+
+	return nbytes;
+}
+
+int XInputUSB::recv(void * buffer, uint8_t nbytes) {
+	if (OutLength == 0) return 0;
+
+	const uint8_t length = std::min(nbytes, OutLength);
+	memcpy(buffer, OutBuffer, length);
+	OutLength = 0;
+	return length;
+}
+
+void XInputUSB::setRecvCallback(void(*callback)(void)) {
+	RecvCallback = callback;
+}
+
+boolean XInputUSB::sendReady(void) {
+	return BankCount < Config.banks;
+}
+
+void XInputUSB::setPollCallback(void(*callback)(void)) {
+	PollCallback = callback;
+}
+
+// --------------------------------------------------------
+// XInput Host Simulator                                  |
+// --------------------------------------------------------
+
+const XInputSimConfig & XInputSim::getConfig() {
+	return Config;
+}
+
+void XInputSim::markInput() {
+	if (MarkPending) return;  // Keep the oldest unsent input
+	MarkPending = true;
+	MarkTime = SimTime;
+}
+
+uint64_t XInputSim::now() {
+	return SimTime;
+}
+
+void XInputSim::advance(uint32_t us) {
+	if (InInterrupt) return;  // Clock is stopped in interrupts
+	runUntil(SimTime + us);
+}
+
+double XInputSim::hostMicros() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int XInputSim::getPin(uint8_t pin) {
+	return Pins[pin];
+}
+
+void XInputSim::setPin(uint8_t pin, int val) {
+	const boolean was = Pins[pin] != 0;
+	const boolean now = val != 0;
+	Pins[pin] = val;
+
+	const int mode = PinInterrupts[pin].mode;
+	if (PinInterrupts[pin].isr == nullptr || was == now) return;
+	if ((mode == RISING && !now) || (mode == FALLING && now)) return;
+
+	const boolean nested = InInterrupt;
+	InInterrupt = true;
+	PinInterrupts[pin].isr();
+	InInterrupt = nested;
+}
+
+uint32_t XInputSim::random() {
+	// xorshift32
+	RandomState ^= RandomState << 13;
+	RandomState ^= RandomState >> 17;
+	RandomState ^= RandomState << 5;
+	return RandomState;
+}
+
+// --------------------------------------------------------
+// Arduino API                                            |
+// --------------------------------------------------------
+
+HostSerial Serial;
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+	return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+unsigned long micros() {
+	XInputSim::advance(1);  // Reading the time takes time too
+	return (unsigned long) (uint32_t) SimTime;
+}
+
+unsigned long millis() {
+	XInputSim::advance(1);
+	return (unsigned long) (uint32_t) (SimTime / 1000);
+}
+
+void delay(unsigned long ms) {
+	XInputSim::advance(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+	XInputSim::advance(us);
+}
+
+void yield() {}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (mode == INPUT_PULLUP) Pins[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+	Pins[pin] = val;
+}
+
+int digitalRead(uint8_t pin) {
+	return Pins[pin] ? HIGH : LOW;
+}
+
+void analogWrite(uint8_t pin, int val) {
+	Pins[pin] = val;
+}
+
+int analogRead(uint8_t pin) {
+	return Pins[pin];
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+	PinInterrupts[interrupt].isr = isr;
+	PinInterrupts[interrupt].mode = mode;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+	PinInterrupts[interrupt].isr = nullptr;
+}
+
+long random(long howbig) {
+	if (howbig <= 0) return 0;
+	return XInputSim::random() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+	if (howsmall >= howbig) return howsmall;
+	return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+	if (seed != 0) RandomState = seed;
+}
+
+size_t Print::write(const uint8_t * buffer, size_t size) {
+	size_t n = 0;
+	while (size--) n += write(*buffer++);
+	return n;
+}
+
+size_t Print::print(const char * str) {
+	return write((const uint8_t *) str, strlen(str));
+}
+
+size_t Print::print(const __FlashStringHelper * str) {
+	return print(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(char c) {
+	return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+	return printNumber(n, base, false);
+}
+
+size_t Print::print(int n, int base) {
+	return print((long) n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+	return printNumber(n, base, false);
+}
+
+size_t Print::print(long n, int base) {
+	if (base == DEC && n < 0) return printNumber(-(unsigned long) n, base, true);
+	return printNumber(n, base, false);
+}
+
+size_t Print::print(unsigned long n, int base) {
+	return printNumber(n, base, false);
+}
+
+size_t Print::print(double n, int digits) {
+	char buffer[64];
+	snprintf(buffer, sizeof(buffer), "%.*f", digits, n);
+	return print(buffer);
+}
+
+size_t Print::println() {
+	return print("\r\n");
+}
+
+size_t Print::printNumber(unsigned long n, int base, boolean negative) {
+	if (base < 2) base = DEC;
+
+	char buffer[8 * sizeof(long) + 2];
+	char * str = &buffer[sizeof(buffer) - 1];
+	*str = '\0';
+	do {
+		const char digit = n % base;
+		*--str = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		n /= base;
+	} while (n != 0);
+	if (negative) *--str = '-';
+
+	return print(str);
+}
+
+size_t Stream::readBytes(uint8_t * buffer, size_t length) {
+	size_t count = 0;
+	while (count < length) {
+		const int c = read();
+		if (c < 0) break;
+		buffer[count++] = c;
+	}
+	return count;
+}
+
+size_t HostSerial::write(uint8_t c) {
+	return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HostSerial::write(const uint8_t * buffer, size_t size) {
+	return fwrite(buffer, 1, size, stdout);
+}
+
+// --------------------------------------------------------
+// Simulator Main                                         |
+// --------------------------------------------------------
+
+static int openSocket(const char * path) {
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static void printTimes(const char * name, std::vector<uint32_t> & times) {
+	fprintf(stderr, "%-14s", name);
+	if (times.empty()) {
+		fprintf(stderr, "-\n");
+		return;
+	}
+
+	std::sort(times.begin(), times.end());
+	uint64_t total = 0;
+	for (uint32_t t : times) total += t;
+
+	const size_t n = times.size();
+	fprintf(stderr, "min %u  avg %llu  p50 %u  p99 %u  max %u us (%zu samples)\n",
+		times.front(), (unsigned long long) (total / n), times[n / 2], times[n * 99 / 100], times.back(), n);
+}
+
+static void printReport() {
+	const double seconds = SimTime / 1e6;
+	fprintf(stderr, "\nXInput host simulation, %.1f s\n", seconds);
+	fprintf(stderr, "Host polls    %llu (%llu empty, %llu NAKed)\n",
+		(unsigned long long) Stats.polls, (unsigned long long) Stats.emptyPolls, (unsigned long long) Stats.naks);
+	fprintf(stderr, "Frames read   %llu (%.1f/s)\n",
+		(unsigned long long) Stats.frames, Stats.frames / seconds);
+	fprintf(stderr, "send() calls  %llu (%llu errors, %llu timeouts, %llu us blocked)\n",
+		(unsigned long long) Stats.sends, (unsigned long long) Stats.sendErrors,
+		(unsigned long long) Stats.sendTimeouts, (unsigned long long) Stats.blockedTime);
+	fprintf(stderr, "OUT packets   %llu rumble, %llu LED (%llu NAKed)\n",
+		(unsigned long long) Stats.rumblePackets, (unsigned long long) Stats.ledPackets,
+		(unsigned long long) Stats.outNaks);
+	printTimes("Latency", Stats.latency);
+	printTimes("Queue time", Stats.queueTime);
+}
+
+static void usage(const char * name) {
+	fprintf(stderr, "Usage: %s [-p us] [-k banks] [-s us] [-n ppt] [-e ppt] [-r us] [-l us]\n"
+		"          [-t us] [-i us] [-m blocking|async|pollsync] [-a us] [-d s] [-S seed]\n"
+		"          [-o path] [-u path]\n", name);
+}
+
+int main(int argc, char * argv[]) {
+	const char * outputPath = nullptr;
+	const char * socketPath = nullptr;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:k:s:n:e:r:l:t:i:m:a:d:S:o:u:h")) != -1) {
+		switch (opt) {
+		case 'p': Config.pollInterval = strtoul(optarg, NULL, 10); break;
+		case 'k': Config.banks = strtoul(optarg, NULL, 10); break;
+		case 's': Config.sendTime = strtoul(optarg, NULL, 10); break;
+		case 'n': Config.nakRate = strtoul(optarg, NULL, 10); break;
+		case 'e': Config.errorRate = strtoul(optarg, NULL, 10); break;
+		case 'r': Config.rumbleInterval = strtoul(optarg, NULL, 10); break;
+		case 'l': Config.ledInterval = strtoul(optarg, NULL, 10); break;
+		case 't': Config.loopTime = strtoul(optarg, NULL, 10); break;
+		case 'i': Config.inputInterval = strtoul(optarg, NULL, 10); break;
+		case 'a': Config.leadTime = strtoul(optarg, NULL, 10); break;
+		case 'd': Config.duration = (uint64_t) (strtod(optarg, NULL) * 1e6); break;
+		case 'S': Config.seed = strtoul(optarg, NULL, 10); break;
+		case 'o': outputPath = optarg; break;
+		case 'u': socketPath = optarg; break;
+		case 'm':
+			if (strcmp(optarg, "blocking") == 0) Config.mode = XInputSimMode::Blocking;
+			else if (strcmp(optarg, "async") == 0) Config.mode = XInputSimMode::Async;
+			else if (strcmp(optarg, "pollsync") == 0) Config.mode = XInputSimMode::PollSync;
+			else {
+				fprintf(stderr, "Unknown mode: %s\n", optarg);
+				return 1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (Config.pollInterval == 0 || Config.banks < 1 || Config.banks > MaxBanks) {
+		fprintf(stderr, "Poll interval must be nonzero, and banks 1-%u\n", MaxBanks);
+		return 1;
+	}
+
+	signal(SIGPIPE, SIG_IGN);  // Reader went away, reported by write()
+	if (outputPath != nullptr) {
+		OutputFd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (OutputFd < 0) {
+			fprintf(stderr, "Can't open %s: %s\n", outputPath, strerror(errno));
+			return 1;
+		}
+	}
+	else if (socketPath != nullptr) {
+		OutputFd = openSocket(socketPath);
+		if (OutputFd < 0) {
+			fprintf(stderr, "Can't connect to %s: %s\n", socketPath, strerror(errno));
+			return 1;
+		}
+	}
+
+	randomSeed(Config.seed);
+	NextPoll = Config.pollInterval;
+	NextRumble = Config.rumbleInterval;
+	NextLED = Config.ledInterval;
+
+	setup();
+	while (SimTime < Config.duration) {
+		loop();
+		XInputSim::advance(Config.loopTime);
+	}
+
+	printReport();
+	if (OutputFd >= 0) close(OutputFd);
+	return 0;
+}
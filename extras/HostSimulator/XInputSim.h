@@ -0,0 +1,115 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Simulator
+ *
+ *  A stand-in for the XInputUSB backend and the USB host, for running the
+ *  library and a sketch on Linux. The bus is simulated on a virtual
+ *  clock: the host polls the IN endpoint at a set interval, may NAK, and
+ *  sends rumble and LED OUT packets at set rates. send() blocks while the
+ *  endpoint's banks are full, and can be made to fail with -1.
+ *
+ *  Simulated interrupts (host polls and OUT packets) run whenever the
+ *  sketch or the library calls into the simulator: reading the time,
+ *  delaying, or calling the USB API. The virtual clock only moves at
+ *  those calls and between calls to loop(), so a run is repeatable for
+ *  a given seed.
+ */
+
+#ifndef XInputSim_h
+#define XInputSim_h
+
+#include <stdint.h>
+
+// --------------------------------------------------------
+// XInputUSB Backend API                                  |
+// (See 'extras/XInputUSB_API.md')                        |
+// --------------------------------------------------------
+
+#define USB_XINPUT
+#define USB_XINPUT_ASYNC
+#define USB_XINPUT_POLL
+
+class XInputUSB {
+public:
+	static boolean connected(void);
+	static uint8_t available(void);
+	static int send(const void *buffer, uint8_t nbytes);
+	static int recv(void *buffer, uint8_t nbytes);
+	static void setRecvCallback(void(*callback)(void));
+	static boolean sendReady(void);
+	static void setPollCallback(void(*callback)(void));
+};
+
+// --------------------------------------------------------
+// XInput Host Simulator                                  |
+// --------------------------------------------------------
+
+enum class XInputSimMode : uint8_t {
+	Blocking = 0,  // send() on every change
+	Async = 1,  // setAsyncSend()
+	PollSync = 2,  // setPollSync()
+};
+
+struct XInputSimConfig {
+	uint32_t pollInterval = 1000;  // Host IN poll interval, us
+	uint8_t banks = 1;  // IN endpoint buffers
+	uint32_t sendTime = 20;  // Time send() takes to copy a packet, us
+	uint32_t sendTimeout = 50000;  // Longest send() waits for a free bank before returning -1, us
+	uint16_t nakRate = 0;  // Polls NAKed with data waiting, per 1000
+	uint16_t errorRate = 0;  // send() calls that return -1, per 1000
+	uint32_t rumbleInterval = 0;  // Time between rumble packets, us. 0 for none
+	uint32_t ledInterval = 0;  // Time between LED packets, us. 0 for none
+	uint32_t loopTime = 100;  // Time taken by each call to loop(), us
+	uint32_t inputInterval = 5000;  // Time between simulated input changes, us (used by the sketch)
+	XInputSimMode mode = XInputSimMode::Blocking;  // Send mode (used by the sketch)
+	uint32_t leadTime = 200;  // Sample lead time in the poll synced mode, us (used by the sketch)
+	uint64_t duration = 10000000;  // Length of the run, us
+	uint32_t seed = 1;
+};
+
+class XInputSim {
+public:
+	static const XInputSimConfig & getConfig();
+
+	// Latency. Call just before a setter that changes the report, and the
+	// time until the host reads a frame sent after it is recorded
+	static void markInput();
+
+	// Virtual time
+	static uint64_t now();  // us since the start of the run
+	static void advance(uint32_t us);  // Moves the clock, running any interrupts due
+
+	// Host time, for timing the library's code. The virtual clock doesn't
+	// move while the sketch runs, so it can't be used for that
+	static double hostMicros();
+
+	// Pins, as last written by the sketch
+	static int getPin(uint8_t pin);
+	static void setPin(uint8_t pin, int val);  // Value read back by digitalRead() / analogRead()
+
+	static uint32_t random();
+};
+
+#endif
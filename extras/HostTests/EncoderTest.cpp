@@ -0,0 +1,165 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Tests, Report Encoders
+ *
+ *  Checks the Xbox 360, HID gamepad and Xbox One GIP reports built from
+ *  a set controller state against reports worked out by hand from each
+ *  format's layout (see XInputEncoder.h).
+ */
+
+#include "HostTest.h"
+#include <XInput.h>
+#include <XInputEncoder.h>
+
+// A+Start+RB+Logo, D-pad up+right, LT 255, RT 1, LX -32768, LY 32767,
+// RX 0x1234, RY -1
+static void setState(XInputController & c) {
+	c.releaseAll();
+	c.press(BUTTON_A);
+	c.press(BUTTON_START);
+	c.press(BUTTON_RB);
+	c.press(BUTTON_LOGO);
+	c.setDpad(true, false, false, true);
+	c.setTrigger(TRIGGER_LEFT, 255);
+	c.setTrigger(TRIGGER_RIGHT, 1);
+	c.setJoystick(JOY_LEFT, -32768, 32767);
+	c.setJoystick(JOY_RIGHT, 0x1234, -1);
+}
+
+static void test360(XInputController & c) {
+	static const uint8_t Idle[20] = {
+		0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+	static const uint8_t Golden[20] = {
+		0x00, 0x14,  // Type, size
+		0x19, 0x16,  // Up, right, start / A, RB, logo
+		0xFF, 0x01,  // Triggers
+		0x00, 0x80, 0xFF, 0x7F,  // Left joystick
+		0x34, 0x12, 0xFF, 0xFF,  // Right joystick
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+
+	c.releaseAll();
+	CHECK_BYTES(c.getReport(), Idle, sizeof(Idle), "360 idle");
+	setState(c);
+	CHECK_BYTES(c.getReport(), Golden, sizeof(Golden), "360 report");
+	CHECK_EQUAL(XInputEncoder360::ReportSize, sizeof(Golden));
+}
+
+static void testHID(XInputController & c) {
+	static const uint8_t Idle[13] = {
+		0x00, 0x00,  // Buttons
+		0x08,  // Hat, centered
+		0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+	static const uint8_t Golden[13] = {
+		0xA1, 0x04,  // A, RB, Start / Logo
+		0x01,  // Hat, up-right
+		0xFF, 0x01,  // Triggers
+		0x00, 0x80, 0x01, 0x80,  // X, Y (down is positive, so 32767 is -32767)
+		0x34, 0x12, 0x01, 0x00,  // Z, Rz (-1 is 1)
+	};
+
+	XInputEncoderHID encoder;
+
+	c.releaseAll();
+	CHECK_BYTES(encoder.encode(c.getReportData()), Idle, sizeof(Idle), "HID idle");
+	setState(c);
+	CHECK_BYTES(encoder.encode(c.getReportData()), Golden, sizeof(Golden), "HID report");
+	CHECK_EQUAL(XInputEncoderHID::ReportSize, sizeof(Golden));
+
+	// Every hat direction, clockwise from up
+	struct Direction { boolean up, down, left, right; uint8_t hat; };
+	static const Direction Directions[] = {
+		{ false, false, false, false, 8 },  // Centered
+		{ true,  false, false, false, 0 },  // Up
+		{ true,  false, false, true,  1 },  // Up-right
+		{ false, false, false, true,  2 },  // Right
+		{ false, true,  false, true,  3 },  // Down-right
+		{ false, true,  false, false, 4 },  // Down
+		{ false, true,  true,  false, 5 },  // Down-left
+		{ false, false, true,  false, 6 },  // Left
+		{ true,  false, true,  false, 7 },  // Up-left
+
+		// Opposing directions cancel out
+		{ true,  true,  false, false, 8 },
+		{ false, false, true,  true,  8 },
+		{ true,  true,  true,  true,  8 },
+		{ true,  false, true,  true,  0 },
+		{ false, true,  true,  true,  4 },
+		{ true,  true,  true,  false, 6 },
+		{ true,  true,  false, true,  2 },
+	};
+
+	c.releaseAll();
+	for (const Direction & d : Directions) {
+		c.setDpad(d.up, d.down, d.left, d.right, false);  // No SOCD, so the encoder sees every combination
+		const uint8_t * report = encoder.encode(c.getReportData());
+		CHECK_EQUAL(report[2], d.hat);
+		CHECK_EQUAL(report[0] | report[1], 0x00);  // The D-pad isn't in the buttons
+	}
+}
+
+static void testGIP(XInputController & c) {
+	static const uint8_t Idle[18] = {
+		0x20, 0x00, 0x01, 0x0E,  // Input report, sequence 1, 14 byte payload
+		0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	};
+	static const uint8_t Golden[18] = {
+		0x20, 0x00, 0x02, 0x0E,  // Input report, sequence 2, 14 byte payload
+		0x14, 0x29,  // Menu, A / D-pad up, right, RB
+		0xFF, 0x03, 0x04, 0x00,  // Triggers, 10 bit
+		0x00, 0x80, 0xFF, 0x7F,  // Left joystick
+		0x34, 0x12, 0xFF, 0xFF,  // Right joystick
+	};
+
+	XInputEncoderGIP encoder;
+
+	c.releaseAll();
+	CHECK_BYTES(encoder.encode(c.getReportData()), Idle, sizeof(Idle), "GIP idle");
+	setState(c);
+	CHECK_BYTES(encoder.encode(c.getReportData()), Golden, sizeof(Golden), "GIP report");
+	CHECK_EQUAL(XInputEncoderGIP::ReportSize, sizeof(Golden));
+
+	// The sequence runs 1-255, skipping 0
+	for (int i = 3; i <= 255; i++) encoder.encode(c.getReportData());
+	CHECK_EQUAL(encoder.encode(c.getReportData())[2], 1);
+}
+
+void setup() {
+	XInputController controller;
+	controller.setAutoSend(false);
+
+	test360(controller);
+	testHID(controller);
+	testGIP(controller);
+	hostTestEnd("EncoderTest");
+}
+
+void loop() {}
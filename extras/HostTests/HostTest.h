@@ -0,0 +1,83 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Tests
+ *
+ *  Tests of the library's logic on a Linux host. Each test is a sketch
+ *  built with the host simulator (extras/HostSimulator) in place of its
+ *  workload, which runs its checks from setup() and exits with the
+ *  result:
+ *
+ *    cd extras/HostTests
+ *    c++ -std=gnu++11 -Wall -Wno-cpp -DXINPUT_INTERRUPT_BUTTONS=1 \
+ *      -I../HostSimulator -I../../src \
+ *      -o rumble_test RumbleTest.cpp ../HostSimulator/XInputSim.cpp ../../src/[A-Z]*.cpp
+ *    ./rumble_test
+ */
+
+#ifndef HostTest_h
+#define HostTest_h
+
+#include <Arduino.h>
+
+static unsigned int HostTestChecks = 0;
+static unsigned int HostTestFailures = 0;
+
+static inline void hostCheck(boolean ok, const char * expr, const char * file, int line) {
+	HostTestChecks++;
+	if (ok) return;
+	HostTestFailures++;
+	fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+}
+
+static inline void hostCheckEqual(long actual, long expected, const char * expr, const char * file, int line) {
+	HostTestChecks++;
+	if (actual == expected) return;
+	HostTestFailures++;
+	fprintf(stderr, "%s:%d: %s is %ld, expected %ld\n", file, line, expr, actual, expected);
+}
+
+// Compares a buffer against the expected bytes, and prints both if they differ
+static inline void hostCheckBytes(const uint8_t * actual, const uint8_t * expected, size_t length, const char * name, const char * file, int line) {
+	HostTestChecks++;
+	if (memcmp(actual, expected, length) == 0) return;
+	HostTestFailures++;
+	fprintf(stderr, "%s:%d: %s differs\n  got     ", file, line, name);
+	for (size_t i = 0; i < length; i++) fprintf(stderr, " %02X", actual[i]);
+	fprintf(stderr, "\n  expected");
+	for (size_t i = 0; i < length; i++) fprintf(stderr, " %02X", expected[i]);
+	fprintf(stderr, "\n");
+}
+
+#define CHECK(cond) hostCheck((cond), #cond, __FILE__, __LINE__)
+#define CHECK_EQUAL(actual, expected) hostCheckEqual((actual), (expected), #actual, __FILE__, __LINE__)
+#define CHECK_BYTES(actual, expected, length, name) hostCheckBytes((actual), (expected), (length), (name), __FILE__, __LINE__)
+
+// Prints the totals and exits, with a nonzero status if any check failed
+static inline void hostTestEnd(const char * name) {
+	fprintf(stderr, "%s: %u checks, %u failed\n", name, HostTestChecks, HostTestFailures);
+	exit(HostTestFailures == 0 ? 0 : 1);
+}
+
+#endif
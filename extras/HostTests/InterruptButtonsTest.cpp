@@ -0,0 +1,90 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Tests, Interrupt Buttons
+ *
+ *  Checks that interrupt buttons reach the report, both from the pin
+ *  interrupts and from update() in the poll synced sample callback.
+ */
+
+#include "HostTest.h"
+#include <XInput.h>
+#include <XInputInterruptButtons.h>
+
+static const uint8_t PinA = 2;
+static const uint8_t PinB = 3;
+
+static XInputInterruptButtons buttons;
+
+static void sampleButtons() {
+	buttons.update();
+}
+
+static void runLoop(uint32_t us) {
+	const uint32_t start = micros();
+	while (micros() - start < us) {
+		XInput.update();
+		XInputSim::advance(100);
+	}
+}
+
+static void testInterrupt() {
+	XInputSim::setPin(PinA, LOW);  // Set straight from the interrupt
+	CHECK_EQUAL(XInput.getButton(BUTTON_A), 1);
+	XInputSim::setPin(PinA, HIGH);
+	CHECK_EQUAL(XInput.getButton(BUTTON_A), 0);
+}
+
+static void testSampleCallback() {
+	XInput.setPollSync(true);
+	XInput.setSampleCallback(sampleButtons, 200);
+
+	// Without its interrupt the pin is only read by update(), run by
+	// the sample callback from XInput.update()
+	detachInterrupt(digitalPinToInterrupt(PinB));
+	XInputSim::setPin(PinB, LOW);
+	CHECK_EQUAL(XInput.getButton(BUTTON_B), 0);
+
+	runLoop(20000);
+	CHECK_EQUAL(buttons.getButtons(), XInputMap::buttonMask(BUTTON_B));
+	CHECK_EQUAL(XInput.getButton(BUTTON_B), 1);
+
+	XInputSim::setPin(PinB, HIGH);
+	runLoop(20000);
+	CHECK_EQUAL(XInput.getButton(BUTTON_B), 0);
+}
+
+void setup() {
+	buttons.add(BUTTON_A, PinA);
+	buttons.add(BUTTON_B, PinB);
+
+	XInput.begin();
+	buttons.begin();
+
+	testInterrupt();
+	testSampleCallback();
+	hostTestEnd("InterruptButtonsTest");
+}
+
+void loop() {}
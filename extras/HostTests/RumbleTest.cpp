@@ -0,0 +1,166 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Host Tests, Rumble Motor
+ *
+ *  Checks XInputRumbleMotor's level scaling, ramping and kick-start
+ *  timing, with the times passed in directly.
+ */
+
+#include "HostTest.h"
+#include <XInputRumble.h>
+
+static const uint32_t Ms = 1000;  // Motor times are in us
+
+static void testScaling() {
+	XInputRumbleMotor motor;
+	motor.setMinimum(60);
+
+	motor.setLevel(0, 0);
+	CHECK_EQUAL(motor.update(0), 0);
+
+	motor.setLevel(1, 0);  // Lowest level, just over the minimum
+	CHECK_EQUAL(motor.update(0), 61);
+
+	motor.setLevel(128, 0);
+	CHECK_EQUAL(motor.update(0), 60 + (128 * 195 + 127) / 255);
+
+	motor.setLevel(255, 0);
+	CHECK_EQUAL(motor.update(0), 255);
+
+	motor.setLevel(0, 0);
+	CHECK_EQUAL(motor.update(0), 0);
+}
+
+static void testRamp() {
+	XInputRumbleMotor motor;
+	motor.setRamp(2);  // Per ms
+
+	// Up from a stop
+	const uint32_t start = 5000 * Ms;  // Idle time before the start doesn't count
+	motor.setLevel(200, start);
+	CHECK_EQUAL(motor.update(start), 0);
+	CHECK_EQUAL(motor.update(start + 10 * Ms), 20);
+	CHECK_EQUAL(motor.update(start + 10 * Ms + 500), 21);  // Partial steps
+	CHECK_EQUAL(motor.update(start + 50 * Ms), 100);
+	CHECK_EQUAL(motor.update(start + 99 * Ms), 198);
+	CHECK_EQUAL(motor.update(start + 100 * Ms), 200);
+	CHECK_EQUAL(motor.update(start + 200 * Ms), 200);  // Holds at the target
+
+	// Down to a lower level
+	const uint32_t down = start + 200 * Ms;
+	motor.setLevel(100, down);
+	CHECK_EQUAL(motor.update(down + 25 * Ms), 150);
+	CHECK_EQUAL(motor.update(down + 80 * Ms), 100);
+
+	// Stopping ramps down as well
+	const uint32_t stop = down + 80 * Ms;
+	motor.setLevel(0, stop);
+	CHECK_EQUAL(motor.update(stop + 10 * Ms), 80);
+	CHECK_EQUAL(motor.update(stop + 50 * Ms), 0);
+	CHECK_EQUAL(motor.getOutput(), 0);
+}
+
+static void testRampFineUpdates() {
+	// Updates much shorter than one step of the ramp still add up
+	const uint32_t periods[] = { 2, 10, 100, 1000 };
+	for (uint8_t i = 0; i < sizeof(periods) / sizeof(periods[0]); i++) {
+		XInputRumbleMotor motor;
+		motor.setRamp(1);  // Per ms
+
+		const uint32_t start = 1000 * Ms;
+		motor.setLevel(200, start);
+		for (uint32_t t = start; t <= start + 50 * Ms; t += periods[i]) {
+			motor.update(t);
+		}
+		CHECK_EQUAL(motor.getOutput(), 50);
+	}
+}
+
+static void testRampMinimum() {
+	XInputRumbleMotor motor;
+	motor.setMinimum(100);
+	motor.setRamp(1);
+
+	// Starts at the minimum rather than ramping through the dead band
+	motor.setLevel(255, 0);
+	CHECK_EQUAL(motor.update(0), 100);
+	CHECK_EQUAL(motor.update(50 * Ms), 150);
+
+	// Stops once it's ramped down to the minimum
+	motor.setLevel(0, 50 * Ms);
+	CHECK_EQUAL(motor.update(99 * Ms), 101);
+	CHECK_EQUAL(motor.update(101 * Ms), 0);
+}
+
+static void testKick() {
+	XInputRumbleMotor motor;
+	motor.setKick(220, 20);
+
+	// Kicks when starting from a stop, for the kick time
+	const uint32_t start = 1000 * Ms;
+	motor.setLevel(50, start);
+	CHECK_EQUAL(motor.update(start), 220);
+	CHECK_EQUAL(motor.update(start + 19 * Ms), 220);
+	CHECK_EQUAL(motor.update(start + 20 * Ms), 50);
+	CHECK_EQUAL(motor.update(start + 100 * Ms), 50);
+
+	// Not while already running
+	motor.setLevel(80, start + 100 * Ms);
+	CHECK_EQUAL(motor.update(start + 100 * Ms), 80);
+
+	// A stop during the kick ends it at once
+	motor.setLevel(0, start + 200 * Ms);
+	CHECK_EQUAL(motor.update(start + 200 * Ms), 0);
+	motor.setLevel(50, start + 300 * Ms);
+	CHECK_EQUAL(motor.update(start + 305 * Ms), 220);
+	motor.setLevel(0, start + 310 * Ms);
+	CHECK_EQUAL(motor.update(start + 310 * Ms), 0);
+}
+
+static void testKickRollover() {
+	XInputRumbleMotor motor;
+	motor.setKick(255, 10);
+	motor.setRamp(1);
+
+	// The kick times out across the rollover of micros()
+	const uint32_t start = 0xFFFFFFFF - 4 * Ms;
+	motor.setLevel(30, start);
+	CHECK_EQUAL(motor.update(start + 9 * Ms), 255);
+	CHECK_EQUAL(motor.update(start + 10 * Ms), 1);  // Ramps from the end of the kick
+	CHECK_EQUAL(motor.update(start + 30 * Ms), 21);
+	CHECK_EQUAL(motor.update(start + 60 * Ms), 30);
+}
+
+void setup() {
+	testScaling();
+	testRamp();
+	testRampFineUpdates();
+	testRampMinimum();
+	testKick();
+	testKickRollover();
+	hostTestEnd("RumbleTest");
+}
+
+void loop() {}
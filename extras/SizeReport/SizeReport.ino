@@ -0,0 +1,210 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  Example:      SizeReport
+ *  Description:  Reference sketch for measuring the library's flash and RAM
+ *                use. Calls every part of the API that is enabled in
+ *                'XInputConfig.h', so each feature is linked in the same way
+ *                as it would be in a full gamepad sketch.
+ *
+ *                Built once per configuration by 'size_report.sh', which
+ *                reports what each feature costs. Not meant to be run.
+ */
+
+#include <XInput.h>
+#include <XInputRecorder.h>
+#include <XInputRumble.h>
+#include <XInputLEDs.h>
+#include <XInputAnalog.h>
+#include <XInputInterruptButtons.h>
+#include <XInputPins.h>
+#include <XInputMacros.h>
+
+volatile int32_t analogInput = 0;
+volatile boolean buttonInput = false;
+
+#if XINPUT_RECORDER
+uint8_t recordBuffer[64];
+XInputRecorder recorder(recordBuffer, sizeof(recordBuffer));
+XInputPlayer player(recorder);
+#endif
+
+#if XINPUT_RUMBLE
+XInputRumble rumbleOutput(9, 10);
+#endif
+
+#if XINPUT_LED_ANIMATION
+XInputLEDs playerLEDs(4, 5, 6, 7);
+#endif
+
+#if XINPUT_ANALOG
+XInputAnalog analogInputs;
+XINPUT_ANALOG_ISR()
+#endif
+
+#if XINPUT_INTERRUPT_BUTTONS
+XInputInterruptButtons interruptButtons;
+#endif
+
+#if XINPUT_PIN_TABLE
+const XInputPinBinding PinBindings[] = {
+	{ 3, BUTTON_Y },
+	{ 12, BUTTON_LB },
+	{ 13, DPAD_DOWN },
+	{ 14, TRIGGER_RIGHT },
+};
+XInputPins<4> pinInputs(PinBindings);
+#endif
+
+#if XINPUT_MACROS
+const XInputMacroStep MacroSteps[] = {
+	{ BUTTON_RB, true, 20 },
+	{ BUTTON_RB, false, 0 },
+	{ JOY_LEFT, 0, 32767, 20 },
+	XInputMacroStep::wait(100),
+};
+XInputMacros<2> macros;
+#endif
+
+#if XINPUT_RECV_CALLBACK
+void receiveCallback(uint8_t packetType) {
+	(void) packetType;
+	buttonInput = XInput.getRumbleLeft() != 0;
+}
+#endif
+
+void setup() {
+	XInput.setAutoSend(false);
+
+#if XINPUT_INPUT_RANGES
+	XInput.setTriggerRange(0, 1023);
+	XInput.setJoystickRange(0, 1023);
+#endif
+
+#if XINPUT_INPUT_PROCESSING
+	XInput.setDeadzone(JOY_LEFT, 2000);
+	XInput.setResponseCurve(TRIGGER_LEFT, 2.0);
+#endif
+
+#if XINPUT_DEBOUNCE
+	XInput.setDebounce(4);
+#endif
+
+#if XINPUT_RECV_CALLBACK
+	XInput.setReceiveCallback(receiveCallback);
+	XInput.setDeferredReceive(true);
+#endif
+
+	XInput.begin();
+
+#if XINPUT_RECORDER
+	recorder.begin();
+#endif
+
+#if XINPUT_RUMBLE
+	rumbleOutput.setMinimum(60);
+	rumbleOutput.setRamp(4);
+	rumbleOutput.setKick(255, 20);
+	rumbleOutput.begin();
+#endif
+
+#if XINPUT_LED_ANIMATION
+	playerLEDs.begin();
+#endif
+
+#if XINPUT_ANALOG
+	analogInputs.addJoystick(JOY_RIGHT, A0, A1);
+	analogInputs.addTrigger(TRIGGER_RIGHT, A2);
+	analogInputs.setSamples(4);
+	analogInputs.begin();
+#endif
+
+#if XINPUT_INTERRUPT_BUTTONS
+	interruptButtons.add(BUTTON_B, 2);
+	interruptButtons.add(BUTTON_X, 11);
+	interruptButtons.setResendInterval(1000);
+	interruptButtons.begin();
+#endif
+
+#if XINPUT_PIN_TABLE
+	pinInputs.begin();
+#endif
+
+#if XINPUT_MACROS
+	macros.setTurbo(BUTTON_START, 10);
+	macros.begin();
+	macros.play(MacroSteps, 0);
+#endif
+}
+
+void loop() {
+	XInput.setButton(BUTTON_A, buttonInput);
+	XInput.setDpad(buttonInput, false, buttonInput, false);
+	XInput.setTrigger(TRIGGER_LEFT, analogInput);
+	XInput.setJoystick(JOY_LEFT, analogInput, analogInput);
+	XInput.setJoystick(JOY_RIGHT, buttonInput, false, false, buttonInput);
+#if XINPUT_ANALOG
+	analogInputs.update();
+#endif
+#if XINPUT_INTERRUPT_BUTTONS
+	interruptButtons.update();
+#endif
+#if XINPUT_PIN_TABLE
+	pinInputs.update();
+#endif
+#if XINPUT_MACROS
+	macros.setButton(BUTTON_START, buttonInput);
+	macros.update();
+#endif
+	XInput.send();
+	XInput.update();
+
+#if XINPUT_RECORDER
+	if (recorder.available() > 32) {
+		recorder.end();
+		player.begin();
+	}
+	player.update();
+#endif
+
+#if XINPUT_LED_PARSING
+	analogInput = XInput.getPlayer() + (uint8_t) XInput.getLEDPattern();
+#endif
+
+#if XINPUT_LED_ANIMATION
+	playerLEDs.update();
+#endif
+
+#if XINPUT_DEBUG_PRINT
+	XInput.printDebug();
+#endif
+
+#if XINPUT_TELEMETRY
+	XInput.printTelemetry();
+#endif
+
+#if XINPUT_STATS
+	XInput.printStats();
+#endif
+}
@@ -0,0 +1,104 @@
+#!/bin/bash
+#
+# Builds the SizeReport sketch once per library configuration and reports
+# the flash and RAM used by each, relative to the default configuration.
+# Each row disables one feature switch from 'src/XInputConfig.h', so its
+# "saved" columns are what that feature costs.
+#
+# Usage: size_report.sh [fqbn]
+#
+# Requires the Arduino IDE command line ('arduino') with the board package
+# for the fqbn installed, and the library linked into the IDE's libraries
+# folder (see '.github/workflows/ci.yml'). Defaults to the XInput AVR
+# Leonardo.
+#
+# Set MAX_FLASH and/or MAX_RAM (bytes) to fail if the default configuration
+# grows past those limits. If GITHUB_STEP_SUMMARY is set, the report is also
+# written there as a table.
+
+set -e
+
+FQBN=${1:-xinput:avr:leonardo}
+SKETCH="$(cd "$(dirname "$0")" && pwd)/SizeReport.ino"
+
+CONFIGS=(
+	"default:"
+	"no debug print:-DXINPUT_DEBUG_PRINT=0"
+	"no telemetry:-DXINPUT_TELEMETRY=0"
+	"no recorder:-DXINPUT_RECORDER=0"
+	"no input ranges:-DXINPUT_INPUT_RANGES=0"
+	"no input processing:-DXINPUT_INPUT_PROCESSING=0"
+	"no SOCD:-DXINPUT_SOCD=0"
+	"no debounce:-DXINPUT_DEBOUNCE=0"
+	"no rumble output:-DXINPUT_RUMBLE=0"
+	"no analog engine:-DXINPUT_ANALOG=0"
+	"no pin table:-DXINPUT_PIN_TABLE=0"
+	"no macros:-DXINPUT_MACROS=0"
+	"no receive callback:-DXINPUT_RECV_CALLBACK=0"
+	"no LED animation:-DXINPUT_LED_ANIMATION=0"
+	"no LED parsing:-DXINPUT_LED_PARSING=0"
+	"minimal:-DXINPUT_DEBUG_PRINT=0 -DXINPUT_TELEMETRY=0 -DXINPUT_RECORDER=0 -DXINPUT_INPUT_RANGES=0 -DXINPUT_INPUT_PROCESSING=0 -DXINPUT_SOCD=0 -DXINPUT_DEBOUNCE=0 -DXINPUT_RUMBLE=0 -DXINPUT_ANALOG=0 -DXINPUT_PIN_TABLE=0 -DXINPUT_MACROS=0 -DXINPUT_RECV_CALLBACK=0 -DXINPUT_LED_PARSING=0"
+	"with stats:-DXINPUT_STATS=1"
+	"with rumble timer:-DXINPUT_RUMBLE_TIMER=1"
+	"with interrupt buttons:-DXINPUT_INTERRUPT_BUTTONS=1"
+	"HID encoder:-DXINPUT_ENCODER=1"
+	"GIP encoder:-DXINPUT_ENCODER=2"
+)
+
+# Prints "<flash> <ram>" for the sketch built with the given flags
+build_size() {
+	local output
+	output=$(arduino --verify --board "$FQBN" --pref "compiler.cpp.extra_flags=$1" "$SKETCH" 2>&1) || {
+		echo "$output" >&2
+		return 1
+	}
+
+	local flash ram
+	flash=$(echo "$output" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+	ram=$(echo "$output" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+	if [ -z "$flash" ] || [ -z "$ram" ]; then
+		echo "$output" >&2
+		echo "Error: could not read the sketch size" >&2
+		return 1
+	fi
+	echo "$flash $ram"
+}
+
+summary() {
+	if [ -n "$GITHUB_STEP_SUMMARY" ]; then
+		echo "$1" >> "$GITHUB_STEP_SUMMARY"
+	fi
+}
+
+echo "XInput size report, $FQBN"
+printf "%-22s %8s %8s %10s %10s\n" "Configuration" "Flash" "RAM" "Flash saved" "RAM saved"
+summary "### XInput size report, \`$FQBN\`"
+summary ""
+summary "| Configuration | Flash | RAM | Flash saved | RAM saved |"
+summary "|---|---:|---:|---:|---:|"
+
+for config in "${CONFIGS[@]}"; do
+	name=${config%%:*}
+	flags=${config#*:}
+
+	sizes=$(build_size "$flags")
+	read -r flash ram <<< "$sizes"
+	if [ "$name" = "default" ]; then
+		baseFlash=$flash
+		baseRam=$ram
+	fi
+
+	savedFlash=$((baseFlash - flash))
+	savedRam=$((baseRam - ram))
+	printf "%-22s %8d %8d %10d %10d\n" "$name" "$flash" "$ram" "$savedFlash" "$savedRam"
+	summary "| $name | $flash | $ram | $savedFlash | $savedRam |"
+done
+
+if [ -n "$MAX_FLASH" ] && [ "$baseFlash" -gt "$MAX_FLASH" ]; then
+	echo "Error: default configuration uses $baseFlash bytes of flash, over the $MAX_FLASH byte limit" >&2
+	exit 1
+fi
+if [ -n "$MAX_RAM" ] && [ "$baseRam" -gt "$MAX_RAM" ]; then
+	echo "Error: default configuration uses $baseRam bytes of RAM, over the $MAX_RAM byte limit" >&2
+	exit 1
+fi
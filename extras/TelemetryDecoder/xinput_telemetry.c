@@ -0,0 +1,211 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *  XInput Telemetry Decoder
+ *
+ *  Decodes the binary frames written by XInputController::printTelemetry()
+ *  and prints them in the same format as XInputController::printDebug(),
+ *  prefixed with the frame's sequence number and timestamp. Dropped and
+ *  corrupted frames are reported as comments ('#').
+ *
+ *  Build:  cc -O2 -o xinput_telemetry xinput_telemetry.c
+ *  Usage:  xinput_telemetry [-b baud] [device]
+ *
+ *  Reads from the given serial device (e.g. /dev/ttyACM0), or from stdin
+ *  if none is given. Serial devices are set to raw mode at the given baud
+ *  rate, 115200 by default.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* Frame layout, see 'XInputTelemetry' in src/XInput.h */
+#define SYNC1         0xA5
+#define SYNC2         0x5A
+#define REPORT_SIZE   20
+#define PAYLOAD_SIZE  (2 + 4 + REPORT_SIZE)
+#define FRAME_SIZE    (3 + PAYLOAD_SIZE + 1)
+
+/* Report layout, see 'XInputMap' in src/XInput.h */
+#define BUTTON(byte, bit)  ((report[byte] >> (bit)) & 0x01)
+#define AXIS(low)          ((int16_t) (report[(low) + 1] << 8 | report[low]))
+
+static speed_t baudToSpeed(long baud) {
+	switch (baud) {
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	case 230400: return B230400;
+	case 460800: return B460800;
+	case 921600: return B921600;
+	case 1000000: return B1000000;
+	case 2000000: return B2000000;
+	default: return 0;
+	}
+}
+
+static int openSerial(const char *path, long baud) {
+	const speed_t speed = baudToSpeed(baud);
+	if (speed == 0) {
+		fprintf(stderr, "Unsupported baud rate: %ld\n", baud);
+		return -1;
+	}
+
+	const int fd = open(path, O_RDONLY | O_NOCTTY);
+	if (fd < 0) {
+		fprintf(stderr, "Can't open %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+
+	struct termios tty;
+	if (tcgetattr(fd, &tty) == 0) {  /* Skip for files and pipes */
+		cfmakeraw(&tty);
+		cfsetispeed(&tty, speed);
+		cfsetospeed(&tty, speed);
+		tty.c_cc[VMIN] = 1;
+		tty.c_cc[VTIME] = 0;
+		if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+			fprintf(stderr, "Can't configure %s: %s\n", path, strerror(errno));
+			close(fd);
+			return -1;
+		}
+	}
+	return fd;
+}
+
+/* Same output as XInputController::printDebug() */
+static void printReport(const uint8_t *report) {
+	const char fill = '_';
+
+	printf("XInput Debug: ");
+
+	printf("LT: %3u %s L:(%6d, %6d, %s)",
+		report[4],
+		BUTTON(3, 0) ? "LB" : "__",
+		AXIS(6), AXIS(8),
+		BUTTON(2, 6) ? "L3" : "__");
+
+	printf(" %c%c%c%c | %c%c%c | %c%c%c%c ",
+		BUTTON(2, 2) ? '<' : fill, BUTTON(2, 0) ? '^' : fill,
+		BUTTON(2, 1) ? 'v' : fill, BUTTON(2, 3) ? '>' : fill,
+		BUTTON(2, 5) ? '<' : fill, BUTTON(3, 2) ? 'X' : fill, BUTTON(2, 4) ? '>' : fill,
+		BUTTON(3, 4) ? 'A' : fill, BUTTON(3, 5) ? 'B' : fill,
+		BUTTON(3, 6) ? 'X' : fill, BUTTON(3, 7) ? 'Y' : fill);
+
+	printf("R:(%6d, %6d, %s) %s RT: %3u\n",
+		AXIS(10), AXIS(12),
+		BUTTON(2, 7) ? "R3" : "__",
+		BUTTON(3, 1) ? "RB" : "__",
+		report[5]);
+}
+
+int main(int argc, char *argv[]) {
+	long baud = 115200;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "b:h")) != -1) {
+		switch (opt) {
+		case 'b':
+			baud = strtol(optarg, NULL, 10);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-b baud] [device]\n", argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	int fd = STDIN_FILENO;
+	if (optind < argc) {
+		fd = openSerial(argv[optind], baud);
+		if (fd < 0) return 1;
+	}
+
+	uint8_t buffer[4096];
+	size_t length = 0;
+	uint16_t lastSequence = 0;
+	int synced = 0;
+
+	while (1) {
+		const ssize_t n = read(fd, buffer + length, sizeof(buffer) - length);
+		if (n == 0) break;  /* End of input */
+		if (n < 0) {
+			if (errno == EINTR) continue;
+			fprintf(stderr, "Read error: %s\n", strerror(errno));
+			return 1;
+		}
+		length += n;
+
+		size_t pos = 0;
+		while (length - pos >= FRAME_SIZE) {
+			const uint8_t *frame = buffer + pos;
+
+			if (frame[0] != SYNC1 || frame[1] != SYNC2 || frame[2] != PAYLOAD_SIZE) {
+				pos++;  /* Not a frame start, resync */
+				continue;
+			}
+
+			uint8_t checksum = 0;
+			for (int i = 2; i < FRAME_SIZE - 1; i++) {
+				checksum ^= frame[i];
+			}
+			if (checksum != frame[FRAME_SIZE - 1]) {
+				printf("# checksum error\n");
+				pos++;
+				continue;
+			}
+
+			const uint16_t sequence = frame[3] | frame[4] << 8;
+			const uint32_t time = (uint32_t) frame[5] | (uint32_t) frame[6] << 8
+				| (uint32_t) frame[7] << 16 | (uint32_t) frame[8] << 24;
+
+			if (synced && sequence == 0) {
+				printf("# sequence reset\n");  /* XInputController::reset() */
+			}
+			else if (synced && sequence != (uint16_t) (lastSequence + 1)) {
+				printf("# %u frame(s) missing\n", (uint16_t) (sequence - lastSequence - 1));
+			}
+			lastSequence = sequence;
+			synced = 1;
+
+			printf("%5u %10lu ", sequence, (unsigned long) time);
+			printReport(frame + 9);
+			pos += FRAME_SIZE;
+		}
+
+		/* Keep the partial frame for the next read */
+		memmove(buffer, buffer + pos, length - pos);
+		length -= pos;
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -25,6 +25,10 @@
  */
 
 #include "XInput.h"
+#include "XInputRecorder.h"
+#include "XInputRumble.h"
+
+#include <stddef.h>  // offsetof
 
  // AVR Board with USB support
 #if defined(USBCON)
@@ -57,153 +61,207 @@
 #endif /* if supported board */
 
 // --------------------------------------------------------
-// XInput Button Maps                                     |
-// (Matches ID to tx index with bitmask)                  |
+// XInput Control Maps                                    |
+// (Table definitions, see header)                        |
 // --------------------------------------------------------
 
-struct XInputMap_Button {
-	constexpr XInputMap_Button(uint8_t i, uint8_t o)
-		: index(i), mask(BuildMask(o)) {}
-	const uint8_t index;
-	const uint8_t mask;
+constexpr XInputMap_Button XInputMap::Buttons[];
+constexpr XInputMap_Trigger XInputMap::Triggers[];
+constexpr XInputMap_Joystick XInputMap::Joysticks[];
 
-private:
-	constexpr static uint8_t BuildMask(uint8_t offset) {
-		return (1 << offset);  // Bitmask of bit to flip
-	}
-};
+// The byte maps and the report struct have to agree
+static_assert(offsetof(XInputReport, buttons) == XInputMap::ButtonsIndex, "Report buttons mismatch");
+static_assert(offsetof(XInputReport, triggers) == XInputMap::Triggers[0].index, "Report triggers mismatch");
+static_assert(offsetof(XInputReport, axes) == XInputMap::Joysticks[0].x_low, "Report axes mismatch");
+static_assert(offsetof(XInputReport, axes) + 2 * sizeof(int16_t) == XInputMap::Joysticks[1].x_low, "Report axes mismatch");
 
-static const XInputMap_Button Map_DpadUp(2, 0);
-static const XInputMap_Button Map_DpadDown(2, 1);
-static const XInputMap_Button Map_DpadLeft(2, 2);
-static const XInputMap_Button Map_DpadRight(2, 3);
-static const XInputMap_Button Map_ButtonStart(2, 4);
-static const XInputMap_Button Map_ButtonBack(2, 5);
-static const XInputMap_Button Map_ButtonL3(2, 6);
-static const XInputMap_Button Map_ButtonR3(2, 7);
-
-static const XInputMap_Button Map_ButtonLB(3, 0);
-static const XInputMap_Button Map_ButtonRB(3, 1);
-static const XInputMap_Button Map_ButtonLogo(3, 2);
-static const XInputMap_Button Map_ButtonA(3, 4);
-static const XInputMap_Button Map_ButtonB(3, 5);
-static const XInputMap_Button Map_ButtonX(3, 6);
-static const XInputMap_Button Map_ButtonY(3, 7);
-
-const XInputMap_Button * getButtonFromEnum(XInputControl ctrl) {
-	switch (ctrl) {
-	case(DPAD_UP):      return &Map_DpadUp;
-	case(DPAD_DOWN):    return &Map_DpadDown;
-	case(DPAD_LEFT):    return &Map_DpadLeft;
-	case(DPAD_RIGHT):   return &Map_DpadRight;
-	case(BUTTON_A):     return &Map_ButtonA;
-	case(BUTTON_B):     return &Map_ButtonB;
-	case(BUTTON_X):     return &Map_ButtonX;
-	case(BUTTON_Y):     return &Map_ButtonY;
-	case(BUTTON_LB):    return &Map_ButtonLB;
-	case(BUTTON_RB):    return &Map_ButtonRB;
-	case(JOY_LEFT):
-	case(BUTTON_L3):    return &Map_ButtonL3;
-	case(JOY_RIGHT):
-	case(BUTTON_R3):    return &Map_ButtonR3;
-	case(BUTTON_START): return &Map_ButtonStart;
-	case(BUTTON_BACK):  return &Map_ButtonBack;
-	case(BUTTON_LOGO):  return &Map_ButtonLogo;
-	default: return nullptr;
-	}
+constexpr XInputController::Range XInputController::TriggerRange;
+constexpr XInputController::Range XInputController::JoystickRange;
+constexpr uint8_t XInputController::MaxInterfaces;
+
+static const XInputMap_Button * getButtonFromEnum(XInputControl ctrl) {
+	if (!XInputMap::isButton(ctrl)) return nullptr;
+	return &XInputMap::Buttons[ctrl];
+}
+
+static const XInputMap_Trigger * getTriggerFromEnum(XInputControl ctrl) {
+	if (!XInputMap::isTrigger(ctrl)) return nullptr;
+	return &XInputMap::Triggers[ctrl - TRIGGER_LEFT];
+}
+
+static const XInputMap_Joystick * getJoyFromEnum(XInputControl ctrl) {
+	if (!XInputMap::isJoystick(ctrl)) return nullptr;
+	return &XInputMap::Joysticks[ctrl - JOY_LEFT];
 }
 
 // --------------------------------------------------------
-// XInput Trigger Maps                                    |
-// (Matches ID to tx index)                               |
+// XInput Rumble Maps                                     |
+// (Stores rx index and buffer index for each motor)      |
 // --------------------------------------------------------
 
-struct XInputMap_Trigger {
-	constexpr XInputMap_Trigger(uint8_t i)
-		: index(i) {}
-	static const XInputController::Range range;
-	const uint8_t index;
+struct XInputMap_Rumble {
+	constexpr XInputMap_Rumble(uint8_t rIndex, uint8_t bIndex)
+		: rxIndex(rIndex), bufferIndex(bIndex) {}
+	const uint8_t rxIndex;
+	const uint8_t bufferIndex;
 };
 
-const XInputController::Range XInputMap_Trigger::range = { 0, 255 };  // uint8_t
+static const XInputMap_Rumble RumbleLeft(3, 0);   // Large motor
+static const XInputMap_Rumble RumbleRight(4, 1);  // Small motor
 
-static const XInputMap_Trigger Map_TriggerLeft(4);
-static const XInputMap_Trigger Map_TriggerRight(5);
+// --------------------------------------------------------
+// XInput Memory Barrier                                  |
+// (Orders queue writes between the ISR and main loop)    |
+// --------------------------------------------------------
 
-const XInputMap_Trigger * getTriggerFromEnum(XInputControl ctrl) {
-	switch (ctrl) {
-	case(TRIGGER_LEFT): return &Map_TriggerLeft;
-	case(TRIGGER_RIGHT): return &Map_TriggerRight;
-	default: return nullptr;
-	}
+static inline void XInputLib_Barrier() {
+	__asm__ __volatile__("" ::: "memory");
 }
 
 // --------------------------------------------------------
-// XInput Joystick Maps                                   |
-// (Matches ID to tx x/y high/low indices)                |
+// XInput USB Interfaces                                  |
+// (Optional API, see 'extras/XInputUSB_API.md')          |
 // --------------------------------------------------------
 
-struct XInputMap_Joystick {
-	constexpr XInputMap_Joystick(uint8_t xl, uint8_t xh, uint8_t yl, uint8_t yh)
-		: x_low(xl), x_high(xh), y_low(yl), y_high(yh) {}
-	static const XInputController::Range range;
-	const uint8_t x_low;
-	const uint8_t x_high;
-	const uint8_t y_low;
-	const uint8_t y_high;
-};
+// Controller registered on each interface, for routing received packets
+static XInputController * XInputLib_Instances[XInputController::MaxInterfaces] = {};
+
+#ifdef USB_XINPUT
+static boolean XInputLib_Connected(uint8_t iface) {
+	if (iface >= XInputController::MaxInterfaces) return false;  // Error: No such interface
+#ifdef USB_XINPUT_INTERFACES
+	return XInputUSB::connected(iface);
+#else
+	return XInputUSB::connected();
+#endif
+}
 
-const XInputController::Range XInputMap_Joystick::range = { -32768, 32767 };  // int16_t
+static uint8_t XInputLib_Available(uint8_t iface) {
+	if (iface >= XInputController::MaxInterfaces) return 0;  // Error: No such interface
+#ifdef USB_XINPUT_INTERFACES
+	return XInputUSB::available(iface);
+#else
+	return XInputUSB::available();
+#endif
+}
 
-static const XInputMap_Joystick Map_JoystickLeft(6, 7, 8, 9);
-static const XInputMap_Joystick Map_JoystickRight(10, 11, 12, 13);
+static int XInputLib_Send(uint8_t iface, const void * buffer, uint8_t nbytes) {
+	if (iface >= XInputController::MaxInterfaces) return -1;  // Error: No such interface
+#ifdef USB_XINPUT_INTERFACES
+	return XInputUSB::send(iface, buffer, nbytes);
+#else
+	return XInputUSB::send(buffer, nbytes);
+#endif
+}
 
-const XInputMap_Joystick * getJoyFromEnum(XInputControl ctrl) {
-	switch (ctrl) {
-	case(JOY_LEFT): return &Map_JoystickLeft;
-	case(JOY_RIGHT): return &Map_JoystickRight;
-	default: return nullptr;
-	}
+static int XInputLib_Recv(uint8_t iface, void * buffer, uint8_t nbytes) {
+	if (iface >= XInputController::MaxInterfaces) return -1;  // Error: No such interface
+#ifdef USB_XINPUT_INTERFACES
+	return XInputUSB::recv(iface, buffer, nbytes);
+#else
+	return XInputUSB::recv(buffer, nbytes);
+#endif
 }
+#endif
 
 // --------------------------------------------------------
-// XInput Rumble Maps                                     |
-// (Stores rx index and buffer index for each motor)      |
+// XInput USB Send Ready                                  |
+// (Optional API, see 'extras/XInputUSB_API.md')          |
 // --------------------------------------------------------
 
-struct XInputMap_Rumble {
-	constexpr XInputMap_Rumble(uint8_t rIndex, uint8_t bIndex)
-		: rxIndex(rIndex), bufferIndex(bIndex) {}
-	const uint8_t rxIndex;
-	const uint8_t bufferIndex;
-};
-
-static const XInputMap_Rumble RumbleLeft(3, 0);   // Large motor
-static const XInputMap_Rumble RumbleRight(4, 1);  // Small motor
+static boolean XInputLib_Send_Ready(uint8_t iface) {
+#if defined(USB_XINPUT) && defined(USB_XINPUT_ASYNC)
+	if (iface >= XInputController::MaxInterfaces) return true;  // Error: No such interface, sends fail
+#ifdef USB_XINPUT_INTERFACES
+	return XInputUSB::sendReady(iface);
+#else
+	return XInputUSB::sendReady();
+#endif
+#else
+	(void) iface;
+	return true;  // No way to tell, so sends block
+#endif
+}
 
 // --------------------------------------------------------
 // XInput USB Receive Callback                            |
 // --------------------------------------------------------
 
 #ifdef USB_XINPUT
+#ifdef USB_XINPUT_INTERFACES
+static void XInputLib_Receive_Callback(uint8_t iface) {
+#else
 static void XInputLib_Receive_Callback() {
-	XInput.receive();
+	const uint8_t iface = 0;
+#endif
+	if (iface >= XInputController::MaxInterfaces) return;  // Error: No such interface
+
+	XInputController * const controller = XInputLib_Instances[iface];
+	if (controller != nullptr) {
+		controller->receive();
+	}
+	else {
+		uint8_t rx[8];
+		while (XInputLib_Recv(iface, rx, sizeof(rx)) > 0);  // Discard, so the endpoint isn't stalled
+	}
 }
 #endif
 
+// --------------------------------------------------------
+// XInput USB Poll Callback                               |
+// (Optional API, see 'extras/XInputUSB_API.md')          |
+// --------------------------------------------------------
+
+#if defined(USB_XINPUT) && defined(USB_XINPUT_POLL)
+#ifdef USB_XINPUT_INTERFACES
+static void XInputLib_Poll_Callback(uint8_t iface) {
+#else
+static void XInputLib_Poll_Callback() {
+	const uint8_t iface = 0;
+#endif
+	if (iface >= XInputController::MaxInterfaces) return;  // Error: No such interface
+
+	XInputController * const controller = XInputLib_Instances[iface];
+	if (controller != nullptr) {
+		controller->hostPolled();
+	}
+}
+#endif
 
 // --------------------------------------------------------
 // XInputController Class (API)                           |
 // --------------------------------------------------------
 
-XInputController::XInputController() :
-	tx(), rumble() // Zero initialize arrays
+XInputController::XInputController(uint8_t interfaceIndex) :
+	interfaceIndex(interfaceIndex),
+	tx(), frameDepth(0), txPending(false), pollCount(0), rumble(), recvSequence(0) // Zero initialize arrays
+#if XINPUT_RECV_CALLBACK
+	, recvHead(0), recvTail(0)
+#endif
+#if XINPUT_RUMBLE
+	, rumbleOutput(nullptr)
+#endif
+#if XINPUT_INTERRUPT_BUTTONS
+	, busy(0)
+#endif
 {
 	reset();
+	if (interfaceIndex < MaxInterfaces) {
+		XInputLib_Instances[interfaceIndex] = this;  // Route this interface's packets here
+	}
 #ifdef USB_XINPUT
 	XInputUSB::setRecvCallback(XInputLib_Receive_Callback);
 	while(this->receive());  // flush USB OUT buffer
 #endif
+#if defined(USB_XINPUT) && defined(USB_XINPUT_POLL)
+	XInputUSB::setPollCallback(XInputLib_Poll_Callback);
+#endif
+}
+
+XInputController::~XInputController() {
+	if (interfaceIndex < MaxInterfaces && XInputLib_Instances[interfaceIndex] == this) {
+		XInputLib_Instances[interfaceIndex] = nullptr;
+	}
 }
 
 void XInputController::begin() {
@@ -221,17 +279,34 @@ void XInputController::release(uint8_t button) {
 void XInputController::setButton(uint8_t button, boolean state) {
 	const XInputMap_Button * buttonData = getButtonFromEnum((XInputControl) button);
 	if (buttonData != nullptr) {
-		if (getButton(button) == state) return;  // Button hasn't changed
+#if XINPUT_DEBOUNCE
+		if (debounceOption) {
+			const uint16_t bit = XInputMap::buttonMask((XInputControl) button);
+			debounceButtons(state ? bit : 0x0000, bit);
+			return;
+		}
+#endif
+#if XINPUT_INTERRUPT_BUTTONS
+		const BusyGuard guard(*this);  // Keep interrupt input out of the report
+#endif
+		if (getButton(button) == state) {  // Button hasn't changed
+			markUnchanged();
+			return;
+		}
 
 		if (state) { tx[buttonData->index] |= buttonData->mask; }  // Press
 		else { tx[buttonData->index] &= ~(buttonData->mask); }  // Release
-		newData = true;
+		markChanged();
 		autosend();
 	}
 	else {
-		Range * triggerRange = getRangeFromEnum((XInputControl) button);
-		if (triggerRange == nullptr) return;  // Not a trigger (or joystick, but the trigger function will ignore that)
-		setTrigger((XInputControl) button, state ? triggerRange->max : triggerRange->min);  // Treat trigger like a button
+		if (!XInputMap::isTrigger((XInputControl) button)) return;  // Not a trigger
+#if XINPUT_INPUT_RANGES
+		const ScaledRange & triggerRange = *getRangeFromEnum((XInputControl) button);
+#else
+		const Range & triggerRange = TriggerRange;
+#endif
+		setTrigger((XInputControl) button, state ? triggerRange.max : triggerRange.min);  // Treat trigger like a button
 	}
 }
 
@@ -240,33 +315,46 @@ void XInputController::setDpad(XInputControl pad, boolean state) {
 }
 
 void XInputController::setDpad(boolean up, boolean down, boolean left, boolean right, boolean useSOCD) {
+#if XINPUT_SOCD
 	// Simultaneous Opposite Cardinal Directions (SOCD) Cleaner
 	if (useSOCD) {
 		if (up && down) { down = false; }  // Up + Down = Up
 		if (left && right) { left = false; right = false; }  // Left + Right = Neutral
 	}
+#else
+	(void) useSOCD;
+#endif
 
-	const boolean autoSendTemp = autoSendOption;  // Save autosend state
-	autoSendOption = false;  // Disable temporarily
+	constexpr uint16_t mask = XInputMap::buttonMask(DPAD_UP) | XInputMap::buttonMask(DPAD_DOWN)
+		| XInputMap::buttonMask(DPAD_LEFT) | XInputMap::buttonMask(DPAD_RIGHT);
 
-	setDpad(DPAD_UP, up);
-	setDpad(DPAD_DOWN, down);
-	setDpad(DPAD_LEFT, left);
-	setDpad(DPAD_RIGHT, right);
+	uint16_t dpad = 0x0000;
+	if (up) dpad |= XInputMap::buttonMask(DPAD_UP);
+	if (down) dpad |= XInputMap::buttonMask(DPAD_DOWN);
+	if (left) dpad |= XInputMap::buttonMask(DPAD_LEFT);
+	if (right) dpad |= XInputMap::buttonMask(DPAD_RIGHT);
 
-	autoSendOption = autoSendTemp;  // Re-enable from option
-	autosend();
+	setButtons(dpad, mask);  // All four at once, as a single sample if debounced
 }
 
 void XInputController::setTrigger(XInputControl trigger, int32_t val) {
 	const XInputMap_Trigger * triggerData = getTriggerFromEnum(trigger);
 	if (triggerData == nullptr) return;  // Not a trigger
 
-	val = rescaleInput(val, *getRangeFromEnum(trigger), XInputMap_Trigger::range);
-	if (getTrigger(trigger) == val) return;  // Trigger hasn't changed
+	val = scaleInput(trigger, val, TriggerRange);
+#if XINPUT_INPUT_PROCESSING
+	val = processTrigger(trigger, val);
+#endif
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);  // Keep interrupt sends off a half-written report
+#endif
+	if (getTrigger(trigger) == val) {  // Trigger hasn't changed
+		markUnchanged();
+		return;
+	}
 
 	tx[triggerData->index] = val;
-	newData = true;
+	markChanged();
 	autosend();
 }
 
@@ -274,59 +362,60 @@ void XInputController::setJoystick(XInputControl joy, int32_t x, int32_t y) {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return;  // Not a joystick
 
-	x = rescaleInput(x, *getRangeFromEnum(joy), XInputMap_Joystick::range);
-	y = rescaleInput(y, *getRangeFromEnum(joy), XInputMap_Joystick::range);
+	x = scaleInput(joy, x, JoystickRange);
+	y = scaleInput(joy, y, JoystickRange);
 
-	setJoystickDirect(joy, x, y);
+	setJoystickInput(joy, x, y);
 }
 
 void XInputController::setJoystickX(XInputControl joy, int32_t x, boolean invert) {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return;  // Not a joystick
 
-	x = rescaleInput(x, *getRangeFromEnum(joy), XInputMap_Joystick::range);
-	if (invert) x = invertInput(x, XInputMap_Joystick::range);
-
-	if (getJoystickX(joy) == x) return;  // Axis hasn't changed
+	x = scaleInput(joy, x, JoystickRange);
+	if (invert) x = invertInput(x, JoystickRange);
 
-	tx[joyData->x_low] = lowByte(x);
-	tx[joyData->x_high] = highByte(x);
-
-	newData = true;
-	autosend();
+#if XINPUT_INPUT_PROCESSING
+	// Radial processing depends on both axes, so keep the other one
+	setJoystickInput(joy, x, joyInput[joy - JOY_LEFT].y);
+#else
+	setJoystickInput(joy, x, getJoystickY(joy));
+#endif
 }
 
 void XInputController::setJoystickY(XInputControl joy, int32_t y, boolean invert) {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return;  // Not a joystick
 
-	y = rescaleInput(y, *getRangeFromEnum(joy), XInputMap_Joystick::range);
-	if (invert) y = invertInput(y, XInputMap_Joystick::range);
-
-	if (getJoystickY(joy) == y) return;  // Axis hasn't changed
+	y = scaleInput(joy, y, JoystickRange);
+	if (invert) y = invertInput(y, JoystickRange);
 
-	tx[joyData->y_low] = lowByte(y);
-	tx[joyData->y_high] = highByte(y);
-
-	newData = true;
-	autosend();
+#if XINPUT_INPUT_PROCESSING
+	setJoystickInput(joy, joyInput[joy - JOY_LEFT].x, y);
+#else
+	setJoystickInput(joy, getJoystickX(joy), y);
+#endif
 }
 
 void XInputController::setJoystick(XInputControl joy, boolean up, boolean down, boolean left, boolean right, boolean useSOCD) {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return;  // Not a joystick
 
-	const Range & range = XInputMap_Joystick::range;
+	const Range & range = JoystickRange;
 
 	int16_t x = 0;
 	int16_t y = 0;
 
+#if XINPUT_SOCD
 	// Simultaneous Opposite Cardinal Directions (SOCD) Cleaner
 	if (useSOCD) {
 		if (up && down) { down = false; }  // Up + Down = Up
 		if (left && right) { left = false; right = false; }  // Left + Right = Neutral
 	}
-	
+#else
+	(void) useSOCD;
+#endif
+
 	// Analog axis means directions are mutually exclusive. Only change the
 	// output from '0' if the per-axis inputs are different, in order to
 	// avoid the '-1' result from adding the int16 extremes
@@ -342,36 +431,238 @@ void XInputController::setJoystick(XInputControl joy, boolean up, boolean down,
 	setJoystickDirect(joy, x, y);
 }
 
+void XInputController::setJoystickInput(XInputControl joy, int16_t x, int16_t y) {
+#if XINPUT_INPUT_PROCESSING
+	joyInput[joy - JOY_LEFT].x = x;
+	joyInput[joy - JOY_LEFT].y = y;
+
+	processJoystick(joy, x, y);
+#endif
+	setJoystickOutput(joy, x, y);
+}
+
 void XInputController::setJoystickDirect(XInputControl joy, int16_t x, int16_t y) {
-	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
-	if (joyData == nullptr) return;  // Not a joystick
+	if (!XInputMap::isJoystick(joy)) return;  // Not a joystick
 
-	if (getJoystickX(joy) != x) {
-		tx[joyData->x_low] = lowByte(x);
-		tx[joyData->x_high] = highByte(x);
-		newData = true;
-	}
+#if XINPUT_INPUT_PROCESSING
+	joyInput[joy - JOY_LEFT].x = x;
+	joyInput[joy - JOY_LEFT].y = y;
+#endif
 
-	if (getJoystickY(joy) != y) {
-		tx[joyData->y_low] = lowByte(y);
-		tx[joyData->y_high] = highByte(y);
-		newData = true;
-	}
+	setJoystickOutput(joy, x, y);
+}
+
+void XInputController::setJoystickOutput(XInputControl joy, int16_t x, int16_t y) {
+	const uint8_t axis = XInputReport::axisIndex(joy);
 
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);  // Axes are two byte stores on AVR, and x and y go together
+#endif
+	boolean changed = setAxis(axis, x);
+	changed |= setAxis(axis + 1, y);
+
+	if (changed) markChanged();
+	else markUnchanged();
 	autosend();
 }
 
+boolean XInputController::setAxis(uint8_t axis, int16_t val) {
+	const int16_t out = (int16_t) XInputReport::wire((uint16_t) val);
+	if (report.axes[axis] == out) return false;  // Axis hasn't changed
+
+	report.axes[axis] = out;  // One 16-bit store
+	return true;
+}
+
 void XInputController::releaseAll() {
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
 	const uint8_t offset = 2;  // Skip message type and packet size
+	boolean changed = false;
+	for (uint8_t i = offset; i < sizeof(tx); i++) {
+		if (tx[i] != 0x00) { changed = true; break; }
+	}
 	memset(tx + offset, 0x00, sizeof(tx) - offset);  // Clear TX array
-	newData = true;  // Data changed and is unsent
+#if XINPUT_INPUT_PROCESSING
+	memset(joyInput, 0x00, sizeof(joyInput));  // Clear unprocessed joystick values
+#endif
+#if XINPUT_DEBOUNCE
+	debounceRaw = 0x0000;
+	debouncer.reset(0x0000);  // Released at once, not filtered
+#endif
+	if (!changed) {  // Everything was already released
+		markUnchanged();
+		return;
+	}
+	markChanged();  // Data changed and is unsent
 	autosend();
 }
 
+const uint8_t * XInputController::getReport() const {
+	return tx;
+}
+
+const XInputReport & XInputController::getReportData() const {
+	return report;
+}
+
+void XInputController::setReport(const XInputReport & data) {
+	setReport((const uint8_t *) &data);
+}
+
+void XInputController::setReport(const uint8_t * data) {
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	const uint8_t offset = 2;  // Skip message type and packet size
+	if (memcmp(tx + offset, data + offset, sizeof(tx) - offset) == 0) {  // Report hasn't changed
+		markUnchanged();
+		return;
+	}
+
+	memcpy(tx + offset, data + offset, sizeof(tx) - offset);
+#if XINPUT_INPUT_PROCESSING
+	for (uint8_t i = 0; i < 2; i++) {  // Treat as unprocessed, for single axis changes
+		joyInput[i].x = getAxis(i * 2);
+		joyInput[i].y = getAxis(i * 2 + 1);
+	}
+#endif
+#if XINPUT_DEBOUNCE
+	debounceRaw = getButtons();
+	debouncer.reset(debounceRaw);  // Taken as is, not filtered
+#endif
+	markChanged();
+	autosend();
+}
+
+#if XINPUT_RECORDER
+void XInputController::setRecorder(XInputRecorder * rec) {
+	recorder = rec;
+}
+#endif
+
+#if XINPUT_RUMBLE
+void XInputController::setRumbleOutput(XInputRumble * out) {
+	rumbleOutput = out;
+}
+#endif
+
+void XInputController::setButtons(uint16_t buttons) {
+	setButtons(buttons, XInputMap::ButtonsMask);
+}
+
+void XInputController::setButtons(uint16_t buttons, uint16_t mask) {
+#if XINPUT_DEBOUNCE
+	if (debounceOption) {
+		debounceButtons(buttons, mask);
+		return;
+	}
+#endif
+	writeButtons(buttons, mask);
+}
+
+void XInputController::writeButtons(uint16_t buttons, uint16_t mask) {
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	const uint16_t current = getButtons();
+	const uint16_t updated = (current & ~mask) | (buttons & mask & XInputMap::ButtonsMask);
+	if (updated == current) {  // Buttons haven't changed
+		markUnchanged();
+		return;
+	}
+
+	setButtonWord(updated);
+	markChanged();
+	autosend();
+}
+
+void XInputController::pressButtons(uint16_t mask) {
+	setButtons(mask, mask);
+}
+
+void XInputController::releaseButtons(uint16_t mask) {
+	setButtons(0x0000, mask);
+}
+
+#if XINPUT_DEBOUNCE
+void XInputController::setDebounce(uint8_t depth, uint8_t interval, boolean eager) {
+	debounceOption = (depth != 0);
+	debouncer.setDepth(depth);
+	debouncer.setEager(eager);
+	debouncer.reset(getButtons());  // Start from the current state, as settled
+	debounceRaw = getButtons();
+	debounceInterval = interval;
+	debounceTime = millis() - interval;  // Next call samples
+}
+
+void XInputController::debounceButtons(uint16_t buttons, uint16_t mask) {
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	debounceRaw = (debounceRaw & ~mask) | (buttons & mask & XInputMap::ButtonsMask);
+
+	const uint8_t now = millis();
+	if ((uint8_t) (now - debounceTime) < debounceInterval) {  // Not time for a sample
+		markUnchanged();
+		return;
+	}
+	debounceTime = now;
+
+	writeButtons(debouncer.sample(debounceRaw), XInputMap::ButtonsMask);
+}
+#endif
+
 void XInputController::setAutoSend(boolean a) {
 	autoSendOption = a;
 }
 
+void XInputController::beginFrame() {
+	frameDepth++;
+}
+
+int XInputController::commit() {
+	if (frameDepth == 0) return 0;  // No frame in progress
+	if (--frameDepth != 0) return 0;  // Nested frame, wait for outermost commit
+
+	// Changes within the frame that cancelled each other out (e.g. press +
+	// release) are caught by send(), which compares to the last report sent
+	if (!autoSendOption) return 0;
+	return send();
+}
+
+uint32_t XInputController::getChanges() const {
+	if (!txLastValid) return (1UL << XInputMap::NumControls) - 1;  // Nothing sent yet, everything is new
+
+	const uint16_t buttons = XInputReport::wire(report.buttons ^ reportLast.buttons);
+
+	uint32_t changes = 0;
+	for (uint8_t i = 0; i < XInputMap::NumControls; i++) {
+		const XInputControl ctrl = (XInputControl) i;
+		boolean changed;
+
+		if (XInputMap::isJoystick(ctrl)) {  // Axes only, the click is its own button
+			const uint8_t axis = XInputReport::axisIndex(ctrl);
+			changed = report.axes[axis] != reportLast.axes[axis] || report.axes[axis + 1] != reportLast.axes[axis + 1];
+		}
+		else if (XInputMap::isTrigger(ctrl)) {
+			const uint8_t trigger = ctrl - TRIGGER_LEFT;
+			changed = report.triggers[trigger] != reportLast.triggers[trigger];
+		}
+		else {
+			changed = buttons & XInputMap::buttonMask(ctrl);
+		}
+
+		if (changed) changes |= 1UL << i;
+	}
+	return changes;
+}
+
+boolean XInputController::reportChanged() const {
+	return !txLastValid || memcmp(tx, txLast, sizeof(tx)) != 0;
+}
+
 boolean XInputController::getButton(uint8_t button) const {
 	const XInputMap_Button* buttonData = getButtonFromEnum((XInputControl) button);
 	if (buttonData != nullptr) {
@@ -388,6 +679,10 @@ boolean XInputController::getDpad(XInputControl dpad) const {
 	return getButton(dpad);
 }
 
+uint16_t XInputController::getButtons() const {
+	return report.getButtons();
+}
+
 uint8_t XInputController::getTrigger(XInputControl trigger) const {
 	const XInputMap_Trigger * triggerData = getTriggerFromEnum(trigger);
 	if (triggerData == nullptr) return 0;  // Not a trigger
@@ -397,21 +692,18 @@ uint8_t XInputController::getTrigger(XInputControl trigger) const {
 int16_t XInputController::getJoystickX(XInputControl joy) const {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return 0;  // Not a joystick
-	return (tx[joyData->x_high] << 8) | tx[joyData->x_low];
+	return getAxis(XInputReport::axisIndex(joy));
 }
 
 int16_t XInputController::getJoystickY(XInputControl joy) const {
 	const XInputMap_Joystick * joyData = getJoyFromEnum(joy);
 	if (joyData == nullptr) return 0;  // Not a joystick
-	return (tx[joyData->y_high] << 8) | tx[joyData->y_low];
-}
-
-uint8_t XInputController::getPlayer() const {
-	return player;
+	return getAxis(XInputReport::axisIndex(joy) + 1);
 }
 
 uint16_t XInputController::getRumble() const {
-	return rumble[RumbleLeft.bufferIndex] << 8 | rumble[RumbleRight.bufferIndex];
+	const RecvData data = getRecvData();
+	return data.rumbleLeft << 8 | data.rumbleRight;
 }
 
 uint8_t XInputController::getRumbleLeft() const {
@@ -422,17 +714,55 @@ uint8_t XInputController::getRumbleRight() const {
 	return rumble[RumbleRight.bufferIndex];
 }
 
+#if XINPUT_LED_PARSING
+uint8_t XInputController::getPlayer() const {
+	return player;
+}
+
 XInputLEDPattern XInputController::getLEDPattern() const {
 	return ledPattern;
 }
+#endif
+
+XInputController::RecvData XInputController::getRecvData() const {
+	RecvData data;
+	uint8_t sequence;
+
+	// Retry if the ISR wrote the data while it was being read
+	do {
+		sequence = recvSequence;
+		data.rumbleLeft = rumble[RumbleLeft.bufferIndex];
+		data.rumbleRight = rumble[RumbleRight.bufferIndex];
+#if XINPUT_LED_PARSING
+		data.player = player;
+		data.ledPattern = ledPattern;
+#endif
+	} while ((sequence & 0x01) || sequence != recvSequence);
+
+	return data;
+}
 
+#if XINPUT_RECV_CALLBACK
 void XInputController::setReceiveCallback(RecvCallbackType cback) {
 	recvCallback = cback;
 }
 
+void XInputController::setDeferredReceive(boolean a) {
+	deferredRecvOption = a;
+}
+
+uint16_t XInputController::getRecvOverflows() const {
+	uint16_t count;
+	do {
+		count = recvOverflows;
+	} while (count != recvOverflows);  // Re-read if torn by the ISR
+	return count;
+}
+#endif
+
 boolean XInputController::connected() {
 #ifdef USB_XINPUT
-	return XInputUSB::connected();
+	return XInputLib_Connected(interfaceIndex);
 #else
 	return false;
 #endif
@@ -440,44 +770,284 @@ boolean XInputController::connected() {
 
 //Send an update packet to the PC
 int XInputController::send() {
-	if (!newData) return 0;  // TX data hasn't changed
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	if (newData && !reportChanged()) {  // Changes since the last send cancelled out
+		newData = false;
+		txPending = false;  // Host already has this report
+		txStale = false;
+	}
+
+	if (!newData) {  // TX data hasn't changed
+#if XINPUT_STATS
+		stats.sendsSuppressed++;
+#endif
+		return 0;
+	}
+
+	if (pollSyncOption || (asyncOption && !XInputLib_Send_Ready(interfaceIndex))) {
+		if (txStale) { droppedFrames++; }  // Previous pending frame replaced
+		txPending = true;
+		txStale = false;
+		return 0;  // Endpoint busy or waiting for the poll, send later
+	}
+
+	return transmit();
+}
+
+int XInputController::transmit() {
 	newData = false;
-#ifdef USB_XINPUT
-	return XInputUSB::send(tx, sizeof(tx));
+	txPending = false;
+	txStale = false;
+
+#if XINPUT_STATS
+	const uint32_t sendStart = micros();
+#endif
+
+#if defined(USB_XINPUT) && (XINPUT_ENCODER == XINPUT_ENCODER_360)
+	const int result = XInputLib_Send(interfaceIndex, tx, sizeof(tx));  // Sent in place
+#elif defined(USB_XINPUT)
+	const int result = XInputLib_Send(interfaceIndex, encoder.encode(report), XInputEncoder::ReportSize);
 #else
-	printDebug();
-	return sizeof(tx);
+	printDebugFrame();
+	const int result = sizeof(tx);
+#endif
+
+#if XINPUT_STATS
+	recordSend(sendStart, micros(), result);
+#endif
+	if (result >= 0) {
+		memcpy(txLast, tx, sizeof(tx));
+		txLastValid = true;
+	}
+#if XINPUT_RECORDER
+	if (recorder != nullptr && result >= 0) {
+		recorder->record(tx);
+	}
+#endif
+	return result;
+}
+
+void XInputController::update() {
+	// Not guarded as a whole, so callbacks run from here can set interrupt
+	// buttons. The calls that touch the report guard themselves.
+#if XINPUT_RECV_CALLBACK
+	dispatchReceived();
+#endif
+#if XINPUT_DEBOUNCE
+	if (debounceOption) debounceButtons(0x0000, 0x0000);  // Sample held buttons
+#endif
+#if XINPUT_RUMBLE
+	if (rumbleOutput != nullptr) rumbleOutput->update();
+#endif
+
+	if (pollSyncOption) {
+		updatePollSync();
+		return;
+	}
+	if (txPending) send();  // Retry frame waiting on the endpoint
+}
+
+uint8_t XInputController::getInterface() const {
+	return interfaceIndex;
+}
+
+int XInputController::sendAll() {
+	int sent = 0;
+	for (uint8_t i = 0; i < MaxInterfaces; i++) {
+		XInputController * const controller = XInputLib_Instances[i];
+		if (controller != nullptr && controller->send() > 0) sent++;
+	}
+	return sent;
+}
+
+void XInputController::updateAll() {
+	for (uint8_t i = 0; i < MaxInterfaces; i++) {
+		XInputController * const controller = XInputLib_Instances[i];
+		if (controller != nullptr) controller->update();
+	}
+}
+
+void XInputController::updatePollSync() {
+	const uint32_t now = micros();
+
+	// Host polls reported through hostPolled(). The count is read on
+	// both sides of the time so an interrupt can't tear it.
+	uint8_t count;
+	uint32_t time;
+	do {
+		count = pollCount;
+		time = pollTime;
+	} while (count != pollCount);
+
+	if (count != pollCountLast) {
+		pollCountLast = count;
+		scheduler.pollObserved(time);
+		awaitingPoll = false;
+	}
+#if defined(USB_XINPUT) && defined(USB_XINPUT_ASYNC)
+	// Otherwise, the endpoint freeing up means the host read the last frame
+	else if (awaitingPoll && XInputLib_Send_Ready(interfaceIndex)) {
+		scheduler.pollObserved(now);
+		awaitingPoll = false;
+	}
+
+	// Measuring the poll interval: send as soon as the host has read the
+	// last frame, unchanged or not, so the gap between reads is one poll
+	if (scheduler.probing()) {
+		if (awaitingPoll || !XInputLib_Send_Ready(interfaceIndex)) return;
+		if (sampleCallback != nullptr) sampleCallback();
+#if XINPUT_INTERRUPT_BUTTONS
+		const BusyGuard guard(*this);
+#endif
+		if (transmit() >= 0) awaitingPoll = true;
+		return;
+	}
+#endif
+
+	if (!scheduler.sampleDue(now)) return;
+
+	if (sampleCallback != nullptr) {
+		sampleCallback();  // Sets controls, which are held for the send below
+	}
+
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);  // Not before, the callback may set interrupt buttons
+#endif
+	if (newData && !reportChanged()) newData = false;  // Changes cancelled out
+	if (newData && XInputLib_Send_Ready(interfaceIndex)) {
+		transmit();
+		awaitingPoll = true;
+	}
+}
+
+#if XINPUT_INTERRUPT_BUTTONS
+XInputInterruptResult XInputController::setButtonsFromInterrupt(uint16_t buttons, uint16_t mask, boolean sendNow) {
+	if (busy) return XInputInterruptResult::Busy;  // Interrupted a call using the report, try again from the loop
+	const BusyGuard guard(*this);  // In case this is the loop, and an interrupt fires
+
+	const uint16_t current = getButtons();
+	const uint16_t updated = (current & ~mask) | (buttons & mask & XInputMap::ButtonsMask);
+	if (updated != current) {
+		setButtonWord(updated);
+#if XINPUT_DEBOUNCE
+		debounceRaw = (debounceRaw & ~mask) | (updated & mask);
+		debouncer.reset(updated);  // Taken as is, not filtered
+#endif
+		markChanged();
+	}
+
+	if (!sendNow || !newData) return XInputInterruptResult::Set;
+	if (frameDepth != 0 || pollSyncOption) return XInputInterruptResult::Set;  // Sent by commit() or the scheduler
+#if XINPUT_RECORDER
+	if (recorder != nullptr) return XInputInterruptResult::Set;  // The recorder isn't interrupt safe, send from the loop
+#endif
+#if defined(USB_XINPUT) && defined(USB_XINPUT_ASYNC)
+	if (!reportChanged()) {
+		newData = false;  // Changes cancelled out
+		return XInputInterruptResult::Set;
+	}
+	if (XInputLib_Send_Ready(interfaceIndex)) {  // Won't block
+		transmit();
+		return XInputInterruptResult::Sent;
+	}
 #endif
+	return XInputInterruptResult::Set;
+}
+#endif
+
+void XInputController::setPollSync(boolean a) {
+	pollSyncOption = a;
+}
+
+void XInputController::setPollInterval(uint32_t interval) {
+	scheduler.setInterval(interval);
+}
+
+uint32_t XInputController::getPollInterval() const {
+	return scheduler.getInterval();
+}
+
+void XInputController::setSampleCallback(SampleCallbackType cback, uint32_t leadTime) {
+	sampleCallback = cback;
+	scheduler.setLeadTime(leadTime);
+}
+
+void XInputController::hostPolled() {
+	pollTime = micros();
+	pollCount++;
+}
+
+void XInputController::setAsyncSend(boolean a) {
+	asyncOption = a;
+}
+
+boolean XInputController::sendPending() const {
+	return txPending;
+}
+
+uint32_t XInputController::getDroppedFrames() const {
+	return droppedFrames;
 }
 
 int XInputController::receive() {
 #ifdef USB_XINPUT
-	if (XInputUSB::available() == 0) {
+	if (XInputLib_Available(interfaceIndex) == 0) {
 		return 0;  // No packet available
 	}
 
 	// Grab packet and store it in rx array
 	uint8_t rx[8];
-	const int bytesRecv = XInputUSB::recv(rx, sizeof(rx));
+	const int bytesRecv = XInputLib_Recv(interfaceIndex, rx, sizeof(rx));
 
 	// Only process if received 3 or more bytes (min valid packet size)
 	if (bytesRecv >= 3) {
 		const uint8_t PacketType = rx[0];
 
-		// Rumble Packet
-		if (PacketType == (uint8_t)XInputReceiveType::Rumble) {
-			rumble[RumbleLeft.bufferIndex] = rx[RumbleLeft.rxIndex];   // Big weight (Left grip)
-			rumble[RumbleRight.bufferIndex] = rx[RumbleRight.rxIndex];  // Small weight (Right grip)
+		RecvPacket packet = { PacketType, { 0x00, 0x00 } };
+		if (PacketType == (uint8_t)XInputReceiveType::Rumble && bytesRecv > RumbleRight.rxIndex) {
+			packet.data[RumbleLeft.bufferIndex] = rx[RumbleLeft.rxIndex];   // Big weight (Left grip)
+			packet.data[RumbleRight.bufferIndex] = rx[RumbleRight.rxIndex];  // Small weight (Right grip)
+#if XINPUT_RUMBLE
+			if (rumbleOutput != nullptr) {  // Drive the motors now, even if the packet is deferred
+				rumbleOutput->setRumble(packet.data[RumbleLeft.bufferIndex], packet.data[RumbleRight.bufferIndex]);
+			}
+#endif
 		}
-		// LED Packet
+#if XINPUT_LED_PARSING
 		else if (PacketType == (uint8_t)XInputReceiveType::LEDs) {
-			parseLED(rx[2]);
+			packet.data[0] = rx[2];
 		}
+#endif
+
+#if XINPUT_STATS
+		if (PacketType == (uint8_t)XInputReceiveType::Rumble) stats.packetsRumble++;
+		else if (PacketType == (uint8_t)XInputReceiveType::LEDs) stats.packetsLEDs++;
+		else stats.packetsOther++;
+#endif
 
-		// User-defined receive callback
-		if (recvCallback != nullptr) {
-			recvCallback(PacketType);
+#if XINPUT_RECV_CALLBACK
+		if (!deferredRecvOption) {
+			applyPacket(packet);  // Parse and handle now, in the ISR
 		}
+		else {
+			// Queue for update(). If full the packet is dropped, as
+			// the slots still to be read belong to the main loop.
+			const uint8_t head = recvHead;
+			const uint8_t next = (head + 1) & (RecvQueueSize - 1);
+			if (next == recvTail) {
+				recvOverflows++;
+			}
+			else {
+				recvQueue[head] = packet;
+				XInputLib_Barrier();  // Write the packet before publishing it
+				recvHead = next;
+			}
+		}
+#else
+		applyPacket(packet);
+#endif
 	}
 
 	return bytesRecv;
@@ -486,6 +1056,47 @@ int XInputController::receive() {
 #endif
 }
 
+#if XINPUT_RECV_CALLBACK
+void XInputController::dispatchReceived() {
+	uint8_t tail = recvTail;
+	while (tail != recvHead) {
+		XInputLib_Barrier();  // Read the packet after seeing it published
+		const RecvPacket packet = recvQueue[tail];
+		XInputLib_Barrier();
+		tail = (tail + 1) & (RecvQueueSize - 1);
+		recvTail = tail;  // Free the slot
+
+		applyPacket(packet);
+	}
+}
+#endif
+
+void XInputController::applyPacket(const RecvPacket& packet) {
+	recvSequence++;  // Odd, data is being written
+
+	// Rumble Packet
+	if (packet.type == (uint8_t)XInputReceiveType::Rumble) {
+		rumble[RumbleLeft.bufferIndex] = packet.data[RumbleLeft.bufferIndex];
+		rumble[RumbleRight.bufferIndex] = packet.data[RumbleRight.bufferIndex];
+	}
+#if XINPUT_LED_PARSING
+	// LED Packet
+	else if (packet.type == (uint8_t)XInputReceiveType::LEDs) {
+		parseLED(packet.data[0]);
+	}
+#endif
+
+	recvSequence++;  // Even, data is consistent
+
+#if XINPUT_RECV_CALLBACK
+	// User-defined receive callback
+	if (recvCallback != nullptr) {
+		recvCallback(packet.type);
+	}
+#endif
+}
+
+#if XINPUT_LED_PARSING
 void XInputController::parseLED(uint8_t leds) {
 	if (leds > 0x0D) return;  // Not a known pattern
 
@@ -514,26 +1125,25 @@ void XInputController::parseLED(uint8_t leds) {
 	default: return;  // Pattern doesn't affect player #
 	}
 }
+#endif
 
-XInputController::Range * XInputController::getRangeFromEnum(XInputControl ctrl) {
-	switch (ctrl) {
-	case(TRIGGER_LEFT): return &rangeTrigLeft;
-	case(TRIGGER_RIGHT): return &rangeTrigRight;
-	case(JOY_LEFT): return &rangeJoyLeft;
-	case(JOY_RIGHT): return &rangeJoyRight;
-	default: return nullptr;
-	}
+int16_t XInputController::invertInput(int16_t val, const Range& range) {
+	return range.max - val + range.min;
+}
+
+#if XINPUT_INPUT_RANGES
+XInputController::ScaledRange * XInputController::getRangeFromEnum(XInputControl ctrl) {
+	if (ctrl < TRIGGER_LEFT || ctrl > JOY_RIGHT) return nullptr;  // Not a ranged control
+	return &ranges[ctrl - TRIGGER_LEFT];
 }
 
-int32_t XInputController::rescaleInput(int32_t val, const Range& in, const Range& out) {
+int32_t XInputController::rescaleInput(int32_t val, const ScaledRange& in, const Range& out) {
 	if (val <= in.min) return out.min;  // Out of range -
 	if (val >= in.max) return out.max;  // Out of range +
-	if (in.min == out.min && in.max == out.max) return val;  // Ranges identical
-	return map(val, in.min, in.max, out.min, out.max);
-}
+	if (in.factor == 0) return map(val, in.min, in.max, out.min, out.max);  // Too wide for fixed-point
 
-int16_t XInputController::invertInput(int16_t val, const Range& range) {
-	return range.max - val + range.min;
+	const uint32_t offset = (uint32_t) val - (uint32_t) in.min;  // Always positive, less than the span
+	return out.min + (int32_t) ((offset * in.factor) >> RescaleShift);
 }
 
 void XInputController::setTriggerRange(int32_t rangeMin, int32_t rangeMax) {
@@ -549,34 +1159,357 @@ void XInputController::setJoystickRange(int32_t rangeMin, int32_t rangeMax) {
 void XInputController::setRange(XInputControl ctrl, int32_t rangeMin, int32_t rangeMax) {
 	if (rangeMin >= rangeMax) return;  // Error: Max < Min
 
-	Range * range = getRangeFromEnum(ctrl);
+	ScaledRange * range = getRangeFromEnum(ctrl);
 	if (range == nullptr) return;  // Not an addressable range
 
 	range->min = rangeMin;
 	range->max = rangeMax;
+
+	// Precompute the scale factor from the input to the output range,
+	// rounded up so results are never below the map() equivalent.
+	// With an input span of at most 2^16 the error stays within 1 LSB
+	// and (offset * factor) can't overflow 32 bits. Wider spans fall
+	// back to map().
+	const Range & out = XInputMap::isTrigger(ctrl) ? TriggerRange : JoystickRange;
+	const uint32_t inSpan = (uint32_t) rangeMax - (uint32_t) rangeMin;
+	const uint32_t outSpan = (uint32_t) out.max - (uint32_t) out.min;
+
+	if (inSpan > (1UL << RescaleShift)) {
+		range->factor = 0;
+	}
+	else {
+		range->factor = ((outSpan << RescaleShift) + inSpan - 1) / inSpan;
+	}
+}
+#endif
+
+#if XINPUT_INPUT_PROCESSING
+XInputController::AxisProcessor * XInputController::getProcessorFromEnum(XInputControl ctrl) {
+	if (ctrl < TRIGGER_LEFT || ctrl > JOY_RIGHT) return nullptr;  // Not an analog control
+	return &processors[ctrl - TRIGGER_LEFT];
+}
+
+// Converts a value in output units (0-255 trigger, 0-32767 joystick
+// magnitude) to the full 16-bit range used for processing
+uint16_t XInputController::normalizeInput(XInputControl ctrl, uint16_t val) {
+	if (XInputMap::isTrigger(ctrl)) {
+		if (val > (uint16_t) TriggerRange.max) val = TriggerRange.max;
+		return val * 257;  // 255 -> 65535
+	}
+	if (val > (uint16_t) JoystickRange.max) val = JoystickRange.max;
+	return (val << 1) | (val >> 14);  // 32767 -> 65535
+}
+
+void XInputController::setDeadzone(XInputControl ctrl, uint16_t inner, uint16_t outer) {
+	AxisProcessor * proc = getProcessorFromEnum(ctrl);
+	if (proc == nullptr) return;  // Not an analog control
+
+	const uint16_t innerEdge = normalizeInput(ctrl, inner);
+	const uint16_t outerEdge = 0xFFFF - normalizeInput(ctrl, outer);
+	if (innerEdge >= outerEdge) return;  // Error: Deadzones overlap
+
+	proc->inner = innerEdge;
+	proc->outer = outerEdge;
+	updateProcessor(*proc);
+}
+
+void XInputController::setDeadzoneMode(XInputControl joy, XInputDeadzoneMode mode) {
+	if (!XInputMap::isJoystick(joy)) return;  // Not a joystick
+
+	AxisProcessor & proc = *getProcessorFromEnum(joy);
+	proc.mode = mode;
+	updateProcessor(proc);
+}
+
+void XInputController::setAntiDeadzone(XInputControl ctrl, uint16_t minimum) {
+	AxisProcessor * proc = getProcessorFromEnum(ctrl);
+	if (proc == nullptr) return;  // Not an analog control
+
+	proc->anti = normalizeInput(ctrl, minimum);
+	updateProcessor(*proc);
+}
+
+void XInputController::setResponseCurve(XInputControl ctrl, float exponent) {
+	AxisProcessor * proc = getProcessorFromEnum(ctrl);
+	if (proc == nullptr) return;  // Not an analog control
+	if (exponent <= 0.0) return;  // Error: Invalid curve
+
+	for (uint8_t i = 0; i <= CurveSegments; i++) {
+		const float in = (float) i / CurveSegments;
+		proc->curve[i] = (uint8_t) (pow(in, exponent) * 255.0 + 0.5);
+	}
+	proc->linear = (exponent == 1.0);
+	updateProcessor(*proc);
+}
+
+void XInputController::setResponseCurve(XInputControl ctrl, const uint8_t * points, uint8_t numPoints) {
+	AxisProcessor * proc = getProcessorFromEnum(ctrl);
+	if (proc == nullptr) return;  // Not an analog control
+	if (points == nullptr || numPoints < 2) return;  // Error: Not enough points for a curve
+
+	// Resample the user's points onto the lookup table
+	const uint8_t userSegments = numPoints - 1;
+	for (uint8_t i = 0; i <= CurveSegments; i++) {
+		const uint16_t pos = (uint16_t) i * userSegments;  // Position in user segments, scaled by CurveSegments
+		const uint8_t index = pos / CurveSegments;
+		const uint8_t frac = pos % CurveSegments;
+
+		if (index >= userSegments) {
+			proc->curve[i] = points[userSegments];
+			continue;
+		}
+
+		const int16_t delta = (int16_t) points[index + 1] - points[index];
+		proc->curve[i] = points[index] + (delta * frac) / CurveSegments;
+	}
+	proc->linear = false;
+	updateProcessor(*proc);
+}
+
+void XInputController::clearProcessing(XInputControl ctrl) {
+	AxisProcessor * proc = getProcessorFromEnum(ctrl);
+	if (proc == nullptr) return;  // Not an analog control
+
+	resetProcessor(*proc);
+}
+
+void XInputController::resetProcessor(AxisProcessor& proc) {
+	proc.mode = XInputDeadzoneMode::Axial;
+	proc.inner = 0;
+	proc.outer = 0xFFFF;
+	proc.anti = 0;
+
+	for (uint8_t i = 0; i <= CurveSegments; i++) {
+		proc.curve[i] = ((uint16_t) i * 255 + CurveSegments / 2) / CurveSegments;
+	}
+	proc.linear = true;
+	updateProcessor(proc);
+	proc.enabled = false;  // Identity, skip processing
+}
+
+void XInputController::updateProcessor(AxisProcessor& proc) {
+	// Same fixed-point approach as the input ranges, see setRange()
+	const uint32_t span = proc.outer - proc.inner;
+	proc.factor = ((0xFFFFUL << 16) + span - 1) / span;
+	proc.enabled = true;
+}
+
+// Applies the deadzones and response curve to a 16-bit magnitude
+uint16_t XInputController::processMagnitude(const AxisProcessor& proc, uint16_t mag) {
+	if (mag <= proc.inner) return 0;  // Inside deadzone
+	if (mag >= proc.outer) return 0xFFFF;  // Past outer deadzone, saturated
+
+	uint32_t t = ((uint32_t) (mag - proc.inner) * proc.factor) >> 16;  // Position within live zone, 16-bit
+	if (t > 0xFFFF) t = 0xFFFF;
+
+	uint16_t out = t;
+	if (!proc.linear) {
+		// Linear interpolation between curve points, 4096 steps per segment
+		const uint8_t segment = t >> 12;
+		const uint16_t frac = t & 0x0FFF;
+		const int32_t start = proc.curve[segment] * 257;
+		const int32_t end = proc.curve[segment + 1] * 257;
+		out = start + (((end - start) * frac) >> 12);
+	}
+
+	if (proc.anti != 0) {
+		out = proc.anti + (((uint32_t) out * (0xFFFF - proc.anti)) >> 16);
+	}
+	return out;
+}
+
+// Integer square root, for radial magnitude
+static uint16_t isqrt32(uint32_t val) {
+	uint32_t res = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > val) bit >>= 2;
+	while (bit != 0) {
+		if (val >= res + bit) {
+			val -= res + bit;
+			res = (res >> 1) + bit;
+		}
+		else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return res;
+}
+
+void XInputController::processJoystick(XInputControl joy, int16_t& x, int16_t& y) const {
+	const AxisProcessor & proc = processors[joy - TRIGGER_LEFT];
+	if (!proc.enabled) return;
+
+	// Magnitudes, with the int16 minimum clipped so the axes are symmetric
+	const uint16_t absX = x < -JoystickRange.max ? JoystickRange.max : abs(x);
+	const uint16_t absY = y < -JoystickRange.max ? JoystickRange.max : abs(y);
+
+	if (proc.mode == XInputDeadzoneMode::Axial) {
+		const uint16_t outX = processMagnitude(proc, normalizeInput(joy, absX)) >> 1;
+		const uint16_t outY = processMagnitude(proc, normalizeInput(joy, absY)) >> 1;
+		x = x < 0 ? -outX : outX;
+		y = y < 0 ? -outY : outY;
+		return;
+	}
+
+	// Radial: scale the vector so its length follows the curve,
+	// keeping its direction. Lengths past the max (the corners of a
+	// square gate) are treated as the max.
+	const uint16_t length = isqrt32((uint32_t) absX * absX + (uint32_t) absY * absY);
+	if (length == 0) return;  // Centered, nothing to scale
+
+	const uint16_t outLength = processMagnitude(proc, normalizeInput(joy, length)) >> 1;
+
+	int32_t outX = ((int32_t) absX * outLength) / length;
+	int32_t outY = ((int32_t) absY * outLength) / length;
+	if (outX > JoystickRange.max) outX = JoystickRange.max;
+	if (outY > JoystickRange.max) outY = JoystickRange.max;
+
+	x = x < 0 ? -outX : outX;
+	y = y < 0 ? -outY : outY;
+}
+
+uint8_t XInputController::processTrigger(XInputControl trigger, uint8_t val) const {
+	const AxisProcessor & proc = processors[trigger - TRIGGER_LEFT];
+	if (!proc.enabled) return val;
+	return processMagnitude(proc, normalizeInput(trigger, val)) >> 8;
 }
+#endif
 
 // Resets class back to initial values
 void XInputController::reset() {
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
 	// Reset control data (tx)
+#if XINPUT_DEBOUNCE
+	debounceOption = false;
+#endif
 	releaseAll();  // Clear TX buffer
-	tx[0] = 0x00;  // Set tx message type
-	tx[1] = 0x14;  // Set tx packet size (20)
+	report.type = XInputEncoder360::MessageType;  // Set tx message type
+	report.size = XInputEncoder360::ReportSize;  // Set tx packet size (20)
+	txLastValid = false;  // Send the reset state, even if it hasn't changed
+	newData = false;
+	markChanged();
 
 	// Reset received data (rx)
-	player = 0;  // Not connected, no player
+	recvSequence++;
 	memset((void*) rumble, 0x00, sizeof(rumble));  // Clear rumble values
+#if XINPUT_RUMBLE
+	if (rumbleOutput != nullptr) rumbleOutput->setRumble(0, 0);  // Motors off, still attached
+#endif
+#if XINPUT_LED_PARSING
+	player = 0;  // Not connected, no player
 	ledPattern = XInputLEDPattern::Off;  // No LEDs on
+#endif
+	recvSequence++;
 
+#if XINPUT_INPUT_RANGES
 	// Reset rescale ranges
-	setTriggerRange(XInputMap_Trigger::range.min, XInputMap_Trigger::range.max);
-	setJoystickRange(XInputMap_Joystick::range.min, XInputMap_Joystick::range.max);
+	setTriggerRange(TriggerRange.min, TriggerRange.max);
+	setJoystickRange(JoystickRange.min, JoystickRange.max);
+#endif
+
+#if XINPUT_INPUT_PROCESSING
+	// Reset input processing
+	for (uint8_t i = 0; i < 4; i++) {
+		resetProcessor(processors[i]);
+	}
+#endif
 
 	// Clear user-set options
+#if XINPUT_RECV_CALLBACK
 	recvCallback = nullptr;
+	deferredRecvOption = false;
+	recvTail = recvHead;  // Discard queued packets
+	recvOverflows = 0;
+#endif
 	autoSendOption = true;
+	frameDepth = 0;  // Abandon any open frame
+	asyncOption = false;
+	txPending = false;
+	txStale = false;
+	droppedFrames = 0;
+	pollSyncOption = false;
+	awaitingPoll = false;
+	sampleCallback = nullptr;
+	scheduler.reset();
+#if XINPUT_RECORDER
+	recorder = nullptr;
+#endif
+	debugMode = XInputDebugMode::Text;
+	debugOutput = nullptr;
+#if XINPUT_TELEMETRY
+	telemetrySequence = 0;
+#endif
+	pollCountLast = pollCount;
+
+#if XINPUT_STATS
+	resetStats();
+#endif
 }
 
+void XInputController::setDebugMode(XInputDebugMode mode) {
+	debugMode = mode;
+}
+
+void XInputController::setDebugOutput(Print& output) {
+	debugOutput = &output;
+}
+
+#ifndef USB_XINPUT
+void XInputController::printDebugFrame() {
+	Print & output = debugOutput != nullptr ? *debugOutput : Serial;
+
+	switch (debugMode) {
+#if XINPUT_DEBUG_PRINT
+	case(XInputDebugMode::Text):
+		printDebug(output);
+		break;
+#endif
+#if XINPUT_TELEMETRY
+	case(XInputDebugMode::Telemetry):
+		printTelemetry(output);
+		break;
+#endif
+	default:
+		(void) output;  // No output, or compiled out
+		break;
+	}
+}
+#endif
+
+#if XINPUT_TELEMETRY
+void XInputController::printTelemetry(Print &output) {
+	static_assert(sizeof(tx) == XInputTelemetry::ReportSize, "Telemetry report size mismatch");
+
+	const uint32_t time = micros();
+	const uint16_t sequence = telemetrySequence++;
+
+	uint8_t frame[XInputTelemetry::FrameSize];
+	frame[0] = XInputTelemetry::Sync1;
+	frame[1] = XInputTelemetry::Sync2;
+	frame[2] = XInputTelemetry::PayloadSize;
+	frame[3] = lowByte(sequence);
+	frame[4] = highByte(sequence);
+	frame[5] = time;
+	frame[6] = time >> 8;
+	frame[7] = time >> 16;
+	frame[8] = time >> 24;
+	memcpy(frame + 9, tx, sizeof(tx));
+
+	uint8_t checksum = 0;
+	for (uint8_t i = 2; i < XInputTelemetry::FrameSize - 1; i++) {
+		checksum ^= frame[i];
+	}
+	frame[XInputTelemetry::FrameSize - 1] = checksum;
+
+	output.write(frame, sizeof(frame));
+}
+#endif
+
+#if XINPUT_DEBUG_PRINT
 static void fillBuffer(char* buff, const char fill) {
 	uint8_t i = 0;
 	while (true) {
@@ -651,5 +1584,71 @@ void XInputController::printDebug(Print &output) const {
 	);
 	output.println(buffer);
 }
+#endif
+
+#if XINPUT_STATS
+const XInputStats & XInputController::getStats() const {
+	return stats;
+}
+
+void XInputController::resetStats() {
+	memset(&stats, 0x00, sizeof(stats));
+	stats.sendTimeMin = 0xFFFFFFFF;
+	stats.frameAgeMin = 0xFFFFFFFF;
+}
+
+void XInputController::recordSend(uint32_t start, uint32_t end, int result) {
+	if (result < 0) {
+		stats.sendErrors++;
+		return;
+	}
+	stats.framesSent++;
+
+	const uint32_t sendTime = end - start;
+	if (sendTime < stats.sendTimeMin) stats.sendTimeMin = sendTime;
+	if (sendTime > stats.sendTimeMax) stats.sendTimeMax = sendTime;
+	stats.sendTimeTotal += sendTime;
+
+	const uint32_t frameAge = end - frameStart;
+	if (frameAge < stats.frameAgeMin) stats.frameAgeMin = frameAge;
+	if (frameAge > stats.frameAgeMax) stats.frameAgeMax = frameAge;
+	stats.frameAgeTotal += frameAge;
+}
+
+static void printMinAvgMax(Print& output, const char* name, uint32_t min, uint32_t total, uint32_t max, uint32_t count) {
+	output.print(name);
+	if (count == 0) {
+		output.print("-/-/-");
+		return;
+	}
+	output.print(min);
+	output.print('/');
+	output.print(total / count);
+	output.print('/');
+	output.print(max);
+}
+
+void XInputController::printStats(Print &output) const {
+	output.print("XInput Stats: TX ");
+	output.print(stats.framesSent);
+	output.print(" (");
+	output.print(stats.sendErrors);
+	output.print(" err, ");
+	output.print(stats.sendsSuppressed);
+	output.print(" supp, ");
+	output.print(stats.setsUnchanged);
+	output.print(" unch)");
+
+	printMinAvgMax(output, " Send us: ", stats.sendTimeMin, stats.sendTimeTotal, stats.sendTimeMax, stats.framesSent);
+	printMinAvgMax(output, " Age us: ", stats.frameAgeMin, stats.frameAgeTotal, stats.frameAgeMax, stats.framesSent);
+
+	output.print(" RX R/L/?: ");
+	output.print(stats.packetsRumble);
+	output.print('/');
+	output.print(stats.packetsLEDs);
+	output.print('/');
+	output.println(stats.packetsOther);
+}
+#endif
 
 XInputController XInput;
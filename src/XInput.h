@@ -29,6 +29,11 @@
 
 #include <Arduino.h>
 
+#include "XInputConfig.h"
+#include "XInputScheduler.h"
+#include "XInputDebouncer.h"
+#include "XInputEncoder.h"
+
 enum XInputControl : uint8_t {
 	BUTTON_LOGO = 0,
 	BUTTON_A = 1,
@@ -73,10 +78,211 @@ enum class XInputLEDPattern : uint8_t {
 	Alternating = 0x0D,
 };
 
+enum class XInputDeadzoneMode : uint8_t {
+	Axial = 0x00,   // Each axis separately (square deadzone)
+	Radial = 0x01,  // Distance from center (circular deadzone)
+};
+
+enum class XInputDebugMode : uint8_t {
+	Text = 0x00,       // printDebug(), human-readable
+	Telemetry = 0x01,  // printTelemetry(), binary
+	None = 0x02,
+};
+
+enum class XInputInterruptResult : uint8_t {
+	Busy = 0,  // Interrupted a call using the report, nothing was changed
+	Set = 1,   // Buttons set, sent later
+	Sent = 2,  // Buttons set and sent
+};
+
+// --------------------------------------------------------
+// XInput Control Maps                                    |
+// (Matches control ID to tx indices, indexed by enum)    |
+// --------------------------------------------------------
+
+struct XInputMap_Button {
+	constexpr XInputMap_Button()
+		: index(0), mask(0) {}  // Not a button
+	constexpr XInputMap_Button(uint8_t i, uint8_t o)
+		: index(i), mask(BuildMask(o)) {}
+	const uint8_t index;
+	const uint8_t mask;
+
+private:
+	constexpr static uint8_t BuildMask(uint8_t offset) {
+		return (1 << offset);  // Bitmask of bit to flip
+	}
+};
+
+struct XInputMap_Trigger {
+	constexpr XInputMap_Trigger(uint8_t i)
+		: index(i) {}
+	const uint8_t index;
+};
+
+struct XInputMap_Joystick {
+	constexpr XInputMap_Joystick(uint8_t xl, uint8_t xh, uint8_t yl, uint8_t yh)
+		: x_low(xl), x_high(xh), y_low(yl), y_high(yh) {}
+	const uint8_t x_low;
+	const uint8_t x_high;
+	const uint8_t y_low;
+	const uint8_t y_high;
+};
+
+struct XInputMap {
+	static constexpr uint8_t NumControls = JOY_RIGHT + 1;
+
+	// Indexed by XInputControl. Non-button controls have an empty mask,
+	// joysticks map to their 'click' buttons (L3 / R3).
+	static constexpr XInputMap_Button Buttons[NumControls] = {
+		{ 3, 2 },  // BUTTON_LOGO
+		{ 3, 4 },  // BUTTON_A
+		{ 3, 5 },  // BUTTON_B
+		{ 3, 6 },  // BUTTON_X
+		{ 3, 7 },  // BUTTON_Y
+		{ 3, 0 },  // BUTTON_LB
+		{ 3, 1 },  // BUTTON_RB
+		{ 2, 5 },  // BUTTON_BACK
+		{ 2, 4 },  // BUTTON_START
+		{ 2, 6 },  // BUTTON_L3
+		{ 2, 7 },  // BUTTON_R3
+		{ 2, 0 },  // DPAD_UP
+		{ 2, 1 },  // DPAD_DOWN
+		{ 2, 2 },  // DPAD_LEFT
+		{ 2, 3 },  // DPAD_RIGHT
+		{},        // TRIGGER_LEFT
+		{},        // TRIGGER_RIGHT
+		{ 2, 6 },  // JOY_LEFT  (L3)
+		{ 2, 7 },  // JOY_RIGHT (R3)
+	};
+
+	// All buttons as a 16-bit little endian word, starting at tx[2]:
+	//   Bit  0: DPAD_UP       Bit  8: BUTTON_LB
+	//   Bit  1: DPAD_DOWN     Bit  9: BUTTON_RB
+	//   Bit  2: DPAD_LEFT     Bit 10: BUTTON_LOGO
+	//   Bit  3: DPAD_RIGHT    Bit 11: (unused)
+	//   Bit  4: BUTTON_START  Bit 12: BUTTON_A
+	//   Bit  5: BUTTON_BACK   Bit 13: BUTTON_B
+	//   Bit  6: BUTTON_L3     Bit 14: BUTTON_X
+	//   Bit  7: BUTTON_R3     Bit 15: BUTTON_Y
+	static constexpr uint8_t ButtonsIndex = 2;
+	static constexpr uint16_t ButtonsMask = 0xF7FF;  // All valid button bits
+
+	// Indexed by XInputControl - TRIGGER_LEFT
+	static constexpr XInputMap_Trigger Triggers[2] = {
+		{ 4 },  // TRIGGER_LEFT
+		{ 5 },  // TRIGGER_RIGHT
+	};
+
+	// Indexed by XInputControl - JOY_LEFT
+	static constexpr XInputMap_Joystick Joysticks[2] = {
+		{ 6, 7, 8, 9 },      // JOY_LEFT
+		{ 10, 11, 12, 13 },  // JOY_RIGHT
+	};
+
+	constexpr static boolean isButton(XInputControl ctrl) {
+		return ctrl < NumControls && Buttons[ctrl].mask != 0;
+	}
+
+	// Bit for the control in the 16-bit button word, 0 if not a button
+	constexpr static uint16_t buttonMask(XInputControl ctrl) {
+		return isButton(ctrl) ?
+			(uint16_t) Buttons[ctrl].mask << ((Buttons[ctrl].index - ButtonsIndex) * 8) : 0;
+	}
+
+	constexpr static boolean isTrigger(XInputControl ctrl) {
+		return ctrl == TRIGGER_LEFT || ctrl == TRIGGER_RIGHT;
+	}
+
+	constexpr static boolean isJoystick(XInputControl ctrl) {
+		return ctrl == JOY_LEFT || ctrl == JOY_RIGHT;
+	}
+};
+
+// --------------------------------------------------------
+// XInput Report                                          |
+// (Layout of the 20-byte report, as sent on the wire)    |
+// --------------------------------------------------------
+
+// Multi-byte fields are little endian on the wire. On little endian
+// targets (AVR, ARM) wire() compiles away and the fields can be read and
+// written directly, otherwise use the accessors.
+struct XInputReport {
+	uint8_t type;  // Message type, 0x00
+	uint8_t size;  // Packet size, 0x14 (20)
+	uint16_t buttons;  // Per XInputMap::buttonMask
+	uint8_t triggers[2];  // Left, right
+	int16_t axes[4];  // Left X, left Y, right X, right Y
+	uint8_t reserved[6];
+
+	uint16_t getButtons() const { return wire(buttons); }
+	int16_t getAxis(uint8_t axis) const { return (int16_t) wire((uint16_t) axes[axis]); }
+
+	// Swaps between the wire and native byte order, resolved at compile time
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	constexpr static uint16_t wire(uint16_t v) { return (uint16_t) ((v << 8) | (v >> 8)); }
+#else
+	constexpr static uint16_t wire(uint16_t v) { return v; }
+#endif
+
+	// Index in 'axes' of the joystick's X axis, Y is the one after
+	constexpr static uint8_t axisIndex(XInputControl joy) {
+		return (joy - JOY_LEFT) * 2;
+	}
+} __attribute__((packed, aligned(2)));  // No padding, 16-bit fields stay aligned
+
+static_assert(sizeof(XInputReport) == 20, "XInput report size mismatch");
+
+#if XINPUT_TELEMETRY
+// Binary telemetry frame, written by printTelemetry() and decoded by
+// 'extras/TelemetryDecoder'. Multi-byte values are little endian.
+//
+//   [0]      Sync (0xA5)
+//   [1]      Sync (0x5A)
+//   [2]      Payload length (26)
+//   [3..4]   Sequence number, incremented per frame
+//   [5..8]   Timestamp, micros()
+//   [9..28]  Report (tx data)
+//   [29]     Checksum, XOR of bytes 2 through 28
+struct XInputTelemetry {
+	static constexpr uint8_t Sync1 = 0xA5;
+	static constexpr uint8_t Sync2 = 0x5A;
+	static constexpr uint8_t ReportSize = 20;
+	static constexpr uint8_t PayloadSize = 2 + 4 + ReportSize;
+	static constexpr uint8_t FrameSize = 3 + PayloadSize + 1;
+};
+#endif
+
+#if XINPUT_STATS
+struct XInputStats {
+	uint32_t framesSent;  // Frames transmitted
+	uint32_t sendErrors;  // Frames the backend failed to send (-1)
+	uint32_t sendsSuppressed;  // send() calls with no new data
+	uint32_t setsUnchanged;  // Setter calls that didn't change the data
+
+	uint32_t sendTimeMin;  // Time spent in the backend's send(), us
+	uint32_t sendTimeMax;
+	uint32_t sendTimeTotal;
+
+	uint32_t frameAgeMin;  // Time from the first change to the frame being sent, us
+	uint32_t frameAgeMax;
+	uint32_t frameAgeTotal;
+
+	uint32_t packetsRumble;  // Packets received, by type
+	uint32_t packetsLEDs;
+	uint32_t packetsOther;
+};
+#endif
+
+class XInputRecorder;
+class XInputRumble;
 
 class XInputController {
 public:
-	XInputController();
+	explicit XInputController(uint8_t interfaceIndex=0);  // USB interface to use, see MaxInterfaces
+	~XInputController();
+	XInputController(const XInputController&) = delete;  // Registered by address, see MaxInterfaces
+	XInputController& operator=(const XInputController&) = delete;
 
 	void begin();
 
@@ -97,74 +303,486 @@ public:
 
 	void releaseAll();
 
+	// Set All Buttons (bit order per XInputMap::buttonMask)
+	void setButtons(uint16_t buttons);
+	void setButtons(uint16_t buttons, uint16_t mask);  // Only bits set in 'mask' are changed
+	void pressButtons(uint16_t mask);
+	void releaseButtons(uint16_t mask);
+
+#if XINPUT_DEBOUNCE
+	// Button Debouncing
+	// Filters the buttons set by setButton(), setDpad() and setButtons().
+	// A change is taken after 'depth' samples in a row (1-7, 0 to disable),
+	// sampled at most once every 'interval' ms. In eager mode a change is
+	// taken at once, and the button then holds for 'depth' samples.
+	// Triggers set as buttons are not filtered.
+	void setDebounce(uint8_t depth, uint8_t interval=1, boolean eager=false);
+#endif
+
+	// Set Control Surfaces (Compile-Time)
+	// These resolve the tx index and mask for the control at compile
+	// time, so each call is a single masked store
+	template<XInputControl button> void press() { setButton<button>(true); }
+	template<XInputControl button> void release() { setButton<button>(false); }
+	template<XInputControl button> void setButton(boolean state);
+
+	template<XInputControl joy> void setJoystick(int32_t x, int32_t y);
+
 	// Auto-Send Data
 	void setAutoSend(boolean a);
 
+	// Frame Transactions
+	// Changes made between these calls are auto-sent at most once, on
+	// commit, and only if the frame as a whole changed the tx data
+	void beginFrame();
+	int commit();  // Returns the send() result, or 0 if nothing was sent
+
+	// Pending Changes
+	// send() only transmits a report that differs from the last one sent,
+	// so changes that cancel out (e.g. press + release) never reach the bus
+	uint32_t getChanges() const;  // Controls that differ from the last sent report, bit per XInputControl
+
 	// Read Control Surfaces
 	boolean getButton(uint8_t button) const;
 	boolean getDpad(XInputControl dpad) const;
+	uint16_t getButtons() const;
 	uint8_t getTrigger(XInputControl trigger) const;
 	int16_t getJoystickX(XInputControl joy) const;
 	int16_t getJoystickY(XInputControl joy) const;
 
-	// Received Data
-	uint8_t getPlayer() const;  // Player # assigned to the controller (0 is unassigned)
+	template<XInputControl button> boolean getButton() const;
+
+	// Raw Report
+	// The full 20-byte report, as sent to the host. setReport() sets every
+	// control at once, bypassing the input ranges and processing. The
+	// first two bytes (type and size) are fixed and not copied.
+	const uint8_t * getReport() const;
+	const XInputReport & getReportData() const;  // The same data, by field. No copy is made
+	void setReport(const uint8_t * report);
+	void setReport(const XInputReport & report);
+
+#if XINPUT_RECORDER
+	void setRecorder(XInputRecorder * rec);  // Records every frame sent, see XInputRecorder.h
+#endif
+
+#if XINPUT_RUMBLE
+	void setRumbleOutput(XInputRumble * out);  // Passed every rumble packet, see XInputRumble.h
+#endif
 
+	// Received Data
 	uint16_t getRumble() const;  // Rumble motors. MSB is large weight, LSB is small
 	uint8_t  getRumbleLeft() const;  // Large rumble motor, left grip
 	uint8_t  getRumbleRight() const; // Small rumble motor, right grip
 
+#if XINPUT_LED_PARSING
+	uint8_t getPlayer() const;  // Player # assigned to the controller (0 is unassigned)
 	XInputLEDPattern getLEDPattern() const;  // Returns LED pattern type
+#endif
 
+	// Received data, read together so it can't be torn by the USB ISR
+	struct RecvData {
+		uint8_t rumbleLeft;
+		uint8_t rumbleRight;
+#if XINPUT_LED_PARSING
+		uint8_t player;
+		XInputLEDPattern ledPattern;
+#endif
+	};
+	RecvData getRecvData() const;
+
+#if XINPUT_RECV_CALLBACK
 	// Received Data Callback
 	using RecvCallbackType = void(*)(uint8_t packetType);
 	void setReceiveCallback(RecvCallbackType);
 
+	// Deferred Receive
+	// The USB ISR only queues received packets, which are then parsed and
+	// passed to the callback from update(), in order. Requires calling
+	// update() from the main loop.
+	void setDeferredReceive(boolean a);
+	uint16_t getRecvOverflows() const;  // Packets dropped because the queue was full
+#endif
+
 	// USB IO
 	boolean connected();
 	int send();
 	int receive();
+	void update();  // Services deferred work, call once per loop
+
+	// Multiple Controllers
+	// Each controller is bound to one XInput interface of the backend, and
+	// received packets are routed straight to it. The global 'XInput' object
+	// uses interface 0.
+#ifdef USB_XINPUT_INTERFACES
+	static constexpr uint8_t MaxInterfaces = USB_XINPUT_INTERFACES;
+#else
+	static constexpr uint8_t MaxInterfaces = 1;
+#endif
+	uint8_t getInterface() const;
+	static int sendAll();  // Sends every controller's changes back to back, returns # of reports sent
+	static void updateAll();  // Calls update() for every controller
+
+	// Asynchronous Sending
+	// If the endpoint is busy, send() returns immediately and the frame is
+	// sent by a later send() or update() call. Frames changed while waiting
+	// are collapsed, so only the newest state is sent.
+	void setAsyncSend(boolean a);
+	boolean sendPending() const;  // Frame is waiting for the endpoint
+	uint32_t getDroppedFrames() const;  // Frames replaced before they were sent
+
+#if XINPUT_INTERRUPT_BUTTONS
+	// Interrupt Input
+	// Sets buttons from an ISR, see XInputInterruptButtons.h. If the ISR
+	// interrupted a call that uses the report, nothing is changed and this
+	// returns Busy, so the buttons can be set from the loop instead.
+	// With 'sendNow' the report is sent at once if the endpoint is free
+	// (async backends only) and no frame, poll sync or recorder is active,
+	// and this returns Sent. Otherwise it returns Set, and the change goes
+	// out with the next send(). Buttons set here are not debounced. Also
+	// safe to call from the loop.
+	XInputInterruptResult setButtonsFromInterrupt(uint16_t buttons, uint16_t mask, boolean sendNow=true);
+#endif
+
+	// Host Poll Scheduling
+	// Sends at most once per host poll interval, just before the host is
+	// predicted to poll. The sample callback runs first so the inputs are
+	// as fresh as possible. All sending is done from update(). With async
+	// sends the interval is measured first, sending every frame back to
+	// back for a few polls.
+	using SampleCallbackType = void(*)(void);
+	void setPollSync(boolean a);
+	void setPollInterval(uint32_t interval);  // Nominal, in microseconds. Refined from observed polls
+	uint32_t getPollInterval() const;  // Estimated, in microseconds
+	void setSampleCallback(SampleCallbackType cback, uint32_t leadTime=0);  // Lead time in microseconds
+	void hostPolled();  // Marks a host poll. Safe to call from an ISR
 
 	// Control Input Ranges
 	struct Range { int32_t min; int32_t max; };
 
+	static constexpr Range TriggerRange = { 0, 255 };  // uint8_t
+	static constexpr Range JoystickRange = { -32768, 32767 };  // int16_t
+
+#if XINPUT_INPUT_RANGES
 	void setTriggerRange(int32_t rangeMin, int32_t rangeMax);
 	void setJoystickRange(int32_t rangeMin, int32_t rangeMax);
 	void setRange(XInputControl ctrl, int32_t rangeMin, int32_t rangeMax);
+#endif
+
+#if XINPUT_INPUT_PROCESSING
+	// Input Processing (Deadzones and Response Curves)
+	// Applied to analog joysticks and triggers after rescaling. Values are
+	// in output units, i.e. 0-32767 for joystick magnitude and 0-255 for
+	// triggers. Curves are built into lookup tables when set, so no
+	// floating point math is done per sample.
+	void setDeadzone(XInputControl ctrl, uint16_t inner, uint16_t outer=0);  // Outer is measured in from the max
+	void setDeadzoneMode(XInputControl joy, XInputDeadzoneMode mode);
+	void setAntiDeadzone(XInputControl ctrl, uint16_t minimum);  // Smallest output outside of the deadzone
+	void setResponseCurve(XInputControl ctrl, float exponent);  // 1.0 is linear, > 1.0 is less sensitive near center
+	void setResponseCurve(XInputControl ctrl, const uint8_t * points, uint8_t numPoints);  // Evenly spaced, 0-255 is full scale
+	void clearProcessing(XInputControl ctrl);
+#endif
 
 	// Setup
 	void reset();
 
 	// Debug
+#if XINPUT_DEBUG_PRINT
 	void printDebug(Print& output=Serial) const;
+#endif
+#if XINPUT_TELEMETRY
+	void printTelemetry(Print& output=Serial);  // One binary frame, see XInputTelemetry
+#endif
+	void setDebugMode(XInputDebugMode mode);  // Output from send() on boards without XInput
+	void setDebugOutput(Print& output);
+
+#if XINPUT_STATS
+	// Statistics
+	const XInputStats & getStats() const;
+	void resetStats();
+	void printStats(Print& output=Serial) const;
+#endif
 
 private:
+	const uint8_t interfaceIndex;  // Backend interface this controller sends and receives on
+
 	// Sent Data
-	uint8_t tx[20];  // USB transmit data
+	union {
+		uint8_t tx[20];  // USB transmit data
+		XInputReport report;  // The same, by field
+	};
 	boolean newData;  // Flag for tx data changed
 	boolean autoSendOption;  // Flag for automatically sending data
-	
-	void setJoystickDirect(XInputControl joy, int16_t x, int16_t y);
+
+	uint8_t frameDepth;  // Nesting level of beginFrame() calls, 0 if none
+
+	union {
+		uint8_t txLast[20];  // tx data as last sent
+		XInputReport reportLast;
+	};
+	boolean txLastValid;  // Flag for 'txLast' holding a sent report, cleared on reset
+	boolean reportChanged() const;  // Compares tx to the last sent report
+
+	void setJoystickInput(XInputControl joy, int16_t x, int16_t y);  // With processing
+	void setJoystickDirect(XInputControl joy, int16_t x, int16_t y);  // Without processing
+	void setJoystickOutput(XInputControl joy, int16_t x, int16_t y);
+	boolean setAxis(uint8_t axis, int16_t val);  // Index in XInputReport::axes, returns 'true' if changed
+
+	void writeButtons(uint16_t buttons, uint16_t mask);  // Without debouncing
+
+	int16_t inline getAxis(uint8_t axis) const {
+		return report.getAxis(axis);
+	}
+
+	void inline setButtonWord(uint16_t buttons) {
+		report.buttons = XInputReport::wire(buttons);
+	}
 
 	void inline autosend() {
-		if (autoSendOption) { send(); }
+		if (autoSendOption && frameDepth == 0) { send(); }
+	}
+
+	void inline markChanged() {
+#if XINPUT_STATS
+		if (!newData) { frameStart = micros(); }  // First change in this frame
+#endif
+		newData = true;
+		if (txPending) { txStale = true; }  // Pending frame is now out of date
+	}
+
+	void inline markUnchanged() {
+#if XINPUT_STATS
+		stats.setsUnchanged++;
+#endif
 	}
 
+#if XINPUT_STATS
+	// Statistics
+	XInputStats stats;
+	uint32_t frameStart;  // Time of the first change to the unsent frame
+	void recordSend(uint32_t start, uint32_t end, int result);
+#endif
+
+#if XINPUT_DEBOUNCE
+	// Button Debouncing
+	boolean debounceOption;
+	XInputDebouncer debouncer;
+	uint16_t debounceRaw;  // Unfiltered button states
+	uint8_t debounceInterval;  // ms between samples
+	uint8_t debounceTime;  // Time of the last sample, low byte of millis()
+	void debounceButtons(uint16_t buttons, uint16_t mask);  // Takes a sample if due
+#endif
+
+	// Asynchronous Sending
+	boolean asyncOption;  // Flag for non-blocking sends
+	boolean txPending;  // Frame is waiting for the endpoint
+	boolean txStale;  // Pending frame changed since send() was last called
+	uint32_t droppedFrames;  // Pending frames replaced by newer data
+
+	int transmit();  // Sends the tx data now, regardless of mode
+
+#if XINPUT_ENCODER != XINPUT_ENCODER_360
+	XInputEncoder encoder;  // Writes the report sent, from tx
+#endif
+
+#if XINPUT_RECORDER
+	XInputRecorder * recorder;  // Notified of every frame sent
+#endif
+
+	// Debug Output
+	XInputDebugMode debugMode;  // Output from send() on boards without XInput
+	Print * debugOutput;  // nullptr for Serial
+#ifndef USB_XINPUT
+	void printDebugFrame();
+#endif
+#if XINPUT_TELEMETRY
+	uint16_t telemetrySequence;
+#endif
+
+	// Host Poll Scheduling
+	boolean pollSyncOption;  // Flag for sending in sync with host polls
+	boolean awaitingPoll;  // Sent a frame, waiting for the host to read it
+	SampleCallbackType sampleCallback;  // User-set callback to sample inputs
+	XInputScheduler scheduler;
+	volatile uint32_t pollTime;  // Time of the last host poll, from hostPolled()
+	volatile uint8_t pollCount;  // Incremented on every hostPolled() call
+	uint8_t pollCountLast;  // 'pollCount' as of the last update()
+	void updatePollSync();
+
 	// Received Data
-	volatile uint8_t player;  // Gamepad player #, buffered
 	volatile uint8_t rumble[2];  // Rumble motor data in, buffered
+#if XINPUT_LED_PARSING
+	volatile uint8_t player;  // Gamepad player #, buffered
 	volatile XInputLEDPattern ledPattern;  // LED pattern data in, buffered
-	RecvCallbackType recvCallback;  // User-set callback for received data
+#endif
+	volatile uint8_t recvSequence;  // Incremented before and after writing the above, odd while writing
 
+	struct RecvPacket {
+		uint8_t type;  // XInputReceiveType
+		uint8_t data[2];  // Rumble values, or LED pattern in [0]
+	};
+
+	void applyPacket(const RecvPacket& packet);  // Store packet data and invoke callback
+#if XINPUT_LED_PARSING
 	void parseLED(uint8_t leds);  // Parse LED data and set pattern/player data
+#endif
+
+#if XINPUT_RECV_CALLBACK
+	RecvCallbackType recvCallback;  // User-set callback for received data
+
+	// Deferred Receive (single producer / single consumer queue)
+	static constexpr uint8_t RecvQueueSize = 8;  // Power of two
+	boolean deferredRecvOption;  // Flag for queueing packets in the ISR
+	RecvPacket recvQueue[RecvQueueSize];
+	volatile uint8_t recvHead;  // Next slot to write, only written by the ISR
+	volatile uint8_t recvTail;  // Next slot to read, only written by update()
+	volatile uint16_t recvOverflows;  // Packets dropped with the queue full
+	void dispatchReceived();
+#endif
+
+#if XINPUT_RUMBLE
+	XInputRumble * rumbleOutput;  // Driven straight from receive()
+#endif
+
+#if XINPUT_INTERRUPT_BUTTONS
+	// Interrupt Input
+	volatile uint8_t busy;  // Calls in progress that use the report, interrupt input waits while nonzero
+
+	struct BusyGuard {
+		XInputController & c;
+		BusyGuard(XInputController& c) : c(c) { c.busy++; }
+		~BusyGuard() { c.busy--; }
+	};
+#endif
 
 	// Control Input Ranges
-	Range rangeTrigLeft, rangeTrigRight, rangeJoyLeft, rangeJoyRight;
-	Range * getRangeFromEnum(XInputControl ctrl);
-	static int32_t rescaleInput(int32_t val, const Range& in, const Range &out);
 	static int16_t invertInput(int16_t val, const Range& range);
+
+#if XINPUT_INPUT_RANGES
+	// Input range with a precomputed fixed-point scale factor to the
+	// output range, so rescaling is a multiply and shift (no division)
+	struct ScaledRange : Range {
+		uint32_t factor;  // Output span / input span, 16.16. 0 if out of precision
+	};
+	static constexpr uint8_t RescaleShift = 16;  // Fixed-point fractional bits
+
+	ScaledRange ranges[4];  // Indexed by XInputControl - TRIGGER_LEFT
+	ScaledRange * getRangeFromEnum(XInputControl ctrl);
+	static int32_t rescaleInput(int32_t val, const ScaledRange& in, const Range &out);
+#endif
+
+	int32_t inline scaleInput(XInputControl ctrl, int32_t val, const Range& out) const {
+#if XINPUT_INPUT_RANGES
+		return rescaleInput(val, ranges[ctrl - TRIGGER_LEFT], out);
+#else
+		(void) ctrl;
+		return val < out.min ? out.min : (val > out.max ? out.max : val);  // Input is already in range
+#endif
+	}
+
+#if XINPUT_INPUT_PROCESSING
+	// Input Processing
+	static constexpr uint8_t CurveSegments = 16;
+
+	struct AxisProcessor {
+		boolean enabled;  // Skip processing entirely if 'false'
+		boolean linear;  // Skip the curve lookup table if 'true'
+		XInputDeadzoneMode mode;  // Joysticks only
+		uint16_t inner;  // Inner deadzone edge, normalized to 16 bits
+		uint16_t outer;  // Outer deadzone edge (saturation), normalized to 16 bits
+		uint16_t anti;  // Anti-deadzone (minimum output), normalized to 16 bits
+		uint32_t factor;  // Scale from [inner, outer] to the full range, 16.16
+		uint8_t curve[CurveSegments + 1];  // Response curve lookup table, 0-255
+	};
+
+	AxisProcessor processors[4];  // Indexed by XInputControl - TRIGGER_LEFT
+	struct { int16_t x; int16_t y; } joyInput[2];  // Joystick values before processing
+
+	AxisProcessor * getProcessorFromEnum(XInputControl ctrl);
+	static void resetProcessor(AxisProcessor& proc);
+	static void updateProcessor(AxisProcessor& proc);
+	static uint16_t processMagnitude(const AxisProcessor& proc, uint16_t mag);
+	static uint16_t normalizeInput(XInputControl ctrl, uint16_t val);
+	void processJoystick(XInputControl joy, int16_t& x, int16_t& y) const;
+	uint8_t processTrigger(XInputControl trigger, uint8_t val) const;
+#endif
 };
 
+// --------------------------------------------------------
+// XInputController Compile-Time Functions                |
+// --------------------------------------------------------
+
+template<XInputControl button>
+void XInputController::setButton(boolean state) {
+	static_assert(button < XInputMap::NumControls, "Not an XInput control");
+
+	if (!XInputMap::isButton(button)) {
+		setButton((uint8_t) button, state);  // Trigger, treated like a button
+		return;
+	}
+
+#if XINPUT_DEBOUNCE
+	if (debounceOption) {
+		constexpr uint16_t bit = XInputMap::buttonMask(button);
+		debounceButtons(state ? bit : 0x0000, bit);
+		return;
+	}
+#endif
+
+	constexpr uint8_t index = XInputMap::Buttons[button].index;
+	constexpr uint8_t mask = XInputMap::Buttons[button].mask;
+
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	if (((tx[index] & mask) != 0) == state) {  // Button hasn't changed
+		markUnchanged();
+		return;
+	}
+
+	if (state) { tx[index] |= mask; }  // Press
+	else { tx[index] &= ~mask; }  // Release
+	markChanged();
+	autosend();
+}
+
+template<XInputControl button>
+boolean XInputController::getButton() const {
+	static_assert(button < XInputMap::NumControls, "Not an XInput control");
+
+	if (!XInputMap::isButton(button)) return getButton((uint8_t) button);  // Trigger
+	return tx[XInputMap::Buttons[button].index] & XInputMap::Buttons[button].mask;
+}
+
+template<XInputControl joy>
+void XInputController::setJoystick(int32_t x, int32_t y) {
+	static_assert(XInputMap::isJoystick(joy), "Not a joystick");
+
+	constexpr uint8_t axis = XInputReport::axisIndex(joy);
+
+	x = scaleInput(joy, x, JoystickRange);
+	y = scaleInput(joy, y, JoystickRange);
+
+#if XINPUT_INPUT_PROCESSING
+	if (processors[joy - TRIGGER_LEFT].enabled) {
+		setJoystickInput(joy, x, y);
+		return;
+	}
+
+	joyInput[joy - JOY_LEFT].x = x;
+	joyInput[joy - JOY_LEFT].y = y;
+#endif
+
+#if XINPUT_INTERRUPT_BUTTONS
+	const BusyGuard guard(*this);
+#endif
+	boolean changed = setAxis(axis, x);
+	changed |= setAxis(axis + 1, y);
+
+	if (changed) markChanged();
+	else markUnchanged();
+	autosend();
+}
+
 extern XInputController XInput;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,240 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputAnalog.h"
+
+#if XINPUT_ANALOG
+
+constexpr uint8_t XInputAnalog::MaxChannels;
+constexpr uint16_t XInputAnalog::AnalogMax;
+
+static constexpr uint8_t NoChannel = 0xFF;
+
+// --------------------------------------------------------
+// XInput Analog Interrupt                                |
+// --------------------------------------------------------
+
+static XInputAnalog * XInputAnalog_Active = nullptr;  // Only one can use the ADC
+
+void XInputAnalog::interrupt() {
+#if defined(__AVR__)
+	if (XInputAnalog_Active != nullptr) XInputAnalog_Active->sampleComplete(ADC);
+#endif
+}
+
+// --------------------------------------------------------
+// XInput Analog Inputs                                   |
+// --------------------------------------------------------
+
+XInputAnalog::XInputAnalog() :
+	controller(nullptr), channels(), numChannels(0), sampleShift(2),
+	converting(NoChannel), selected(0), pass(0), sums(), values(), sequence(0), lastSequence(0)
+{}
+
+boolean XInputAnalog::addTrigger(XInputControl trigger, uint8_t pin, boolean invert) {
+	if (!XInputMap::isTrigger(trigger)) return false;  // Error: Not a trigger
+	return addChannel(pin, trigger, invert);
+}
+
+boolean XInputAnalog::addJoystick(XInputControl joy, uint8_t pinX, uint8_t pinY, boolean invertX, boolean invertY) {
+	if (!XInputMap::isJoystick(joy)) return false;  // Error: Not a joystick
+	if (numChannels + 2 > MaxChannels) return false;  // Error: No room for both axes
+	return addChannel(pinX, joy, invertX) && addChannel(pinY, joy, invertY);
+}
+
+boolean XInputAnalog::addChannel(uint8_t pin, XInputControl control, boolean invert) {
+	if (controller != nullptr) return false;  // Error: Already running
+	if (numChannels >= MaxChannels) return false;  // Error: Full
+
+	Channel & c = channels[numChannels++];
+	c.pin = pin;
+	c.mux = pinToMux(pin);
+	c.control = control;
+	c.invert = invert;
+	return true;
+}
+
+void XInputAnalog::setSamples(uint8_t samples) {
+	if (controller != nullptr) return;  // Error: Already running
+	if (samples > 64) samples = 64;  // Sum of 64 fits in 16 bits
+
+	sampleShift = 0;
+	while ((2 << sampleShift) <= samples) sampleShift++;  // Round down to a power of 2
+}
+
+uint8_t XInputAnalog::getSamples() const {
+	return 1 << sampleShift;
+}
+
+void XInputAnalog::begin(XInputController& c) {
+	end();
+	if (numChannels == 0) return;  // Error: Nothing to sample
+	if (XInputAnalog_Active != nullptr) XInputAnalog_Active->end();
+
+	for (uint8_t i = 0; i < numChannels; i++) sums[i] = 0;
+	pass = 0;
+	lastSequence = sequence;  // Nothing to pass on until the first sweep is done
+	controller = &c;
+	XInputAnalog_Active = this;
+
+#if defined(__AVR__)
+	interruptDefined();  // Fails to link if the sketch doesn't have XINPUT_ANALOG_ISR()
+
+	// The first result is converted before the next channel can be
+	// selected, so it's discarded rather than counted twice
+	converting = NoChannel;
+	selected = 0;
+	selectChannel(channels[0].mux);
+
+#if defined(ADTS3)
+	ADCSRB &= ~(_BV(ADTS3) | _BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));  // Free running
+#else
+	ADCSRB &= ~(_BV(ADTS2) | _BV(ADTS1) | _BV(ADTS0));
+#endif
+	ADCSRA |= _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF) | _BV(ADSC);  // Clear any stale flag and start
+#endif
+}
+
+void XInputAnalog::end() {
+	if (controller == nullptr) return;  // Not running
+
+#if defined(__AVR__)
+	ADCSRA &= ~(_BV(ADATE) | _BV(ADIE));
+	while (ADCSRA & _BV(ADSC));  // Let the last conversion finish, so analogRead() starts clean
+#endif
+
+	controller = nullptr;
+	XInputAnalog_Active = nullptr;
+}
+
+void XInputAnalog::update() {
+	if (controller == nullptr) return;  // Not running
+
+#if !defined(__AVR__)
+	// No interrupt engine, take a full sweep here
+	for (uint8_t r = 0; r < getSamples(); r++) {
+		for (uint8_t i = 0; i < numChannels; i++) {
+			sums[i] += analogRead(channels[i].pin);
+		}
+	}
+	publish();
+#endif
+
+	uint16_t v[MaxChannels];
+	uint8_t seq;
+	read(v, seq);
+	if (seq == lastSequence) return;  // No new values
+	lastSequence = seq;
+
+	for (uint8_t i = 0; i < numChannels; i++) {
+		if (channels[i].invert) v[i] = AnalogMax - v[i];
+	}
+
+	for (uint8_t i = 0; i < numChannels; i++) {
+		const XInputControl ctrl = channels[i].control;
+		if (XInputMap::isJoystick(ctrl)) {
+			controller->setJoystick(ctrl, v[i], v[i + 1]);  // Both axes at once, for radial processing
+			i++;
+		}
+		else {
+			controller->setTrigger(ctrl, v[i]);
+		}
+	}
+}
+
+uint8_t XInputAnalog::getChannels() const {
+	return numChannels;
+}
+
+uint16_t XInputAnalog::getValue(uint8_t channel) const {
+	if (channel >= numChannels) return 0;  // Error: No such channel
+
+	uint16_t v[MaxChannels];
+	uint8_t seq;
+	read(v, seq);
+	return v[channel];
+}
+
+void XInputAnalog::sampleComplete(uint16_t value) {
+	const uint8_t ch = converting;
+
+	// In free running mode the next conversion has already started on the
+	// selected channel, so the channel selected now is the one after that
+	converting = selected;
+	if (++selected >= numChannels) selected = 0;
+	selectChannel(channels[selected].mux);
+
+	if (ch == NoChannel) return;  // Started before its channel was set
+	sums[ch] += value;
+
+	if (ch != numChannels - 1) return;  // The last channel ends each pass
+	if (++pass < getSamples()) return;
+	pass = 0;
+	publish();
+}
+
+void XInputAnalog::publish() {
+	sequence++;  // Odd, values are being written
+	for (uint8_t i = 0; i < numChannels; i++) {
+		values[i] = sums[i] >> sampleShift;
+		sums[i] = 0;
+	}
+	sequence++;  // Even, values are consistent
+}
+
+void XInputAnalog::read(uint16_t * out, uint8_t& seq) const {
+	// Retry if the interrupt published while the values were being read
+	do {
+		seq = sequence;
+		for (uint8_t i = 0; i < numChannels; i++) out[i] = values[i];
+	} while ((seq & 0x01) || seq != sequence);
+}
+
+uint8_t XInputAnalog::pinToMux(uint8_t pin) {
+#if defined(__AVR__)
+	if (pin >= A0) pin -= A0;  // Allow for channel or pin numbers, like analogRead()
+#if defined(analogPinToChannel)
+	pin = analogPinToChannel(pin);
+#endif
+	return pin & 0x0F;
+#else
+	(void) pin;
+	return 0;  // Unused, sampled with analogRead()
+#endif
+}
+
+void XInputAnalog::selectChannel(uint8_t mux) {
+#if defined(__AVR__)
+#if defined(MUX5)
+	ADCSRB = (ADCSRB & ~_BV(MUX5)) | ((mux & 0x08) ? _BV(MUX5) : 0);
+#endif
+	ADMUX = (DEFAULT << 6) | (mux & 0x07);  // AVcc reference
+#else
+	(void) mux;
+#endif
+}
+
+#endif  // XINPUT_ANALOG
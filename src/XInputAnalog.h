@@ -0,0 +1,127 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputAnalog_h
+#define XInputAnalog_h
+
+#include "XInput.h"
+
+#if XINPUT_ANALOG
+
+// --------------------------------------------------------
+// XInput Analog Inputs                                   |
+// --------------------------------------------------------
+
+// Samples the analog joysticks and triggers in the background and passes
+// them to the controller, through its input ranges and processing like
+// any other setJoystick() or setTrigger() call.
+//
+// On AVR the ADC runs free, converting each channel in turn from its
+// interrupt, so update() only copies out the latest values and never
+// waits on a conversion. Each value is the average of 'samples'
+// conversions, and a new set is ready every channels * samples * 104 us
+// (16 MHz, default prescaler). analogRead() can't be used while it runs.
+//
+// Other boards don't have the interrupt engine, and take the samples with
+// analogRead() in update() instead.
+//
+// The library doesn't define the ADC interrupt itself, so sketches that
+// don't use XInputAnalog (or that use the ADC for something else) aren't
+// tied to it. A sketch that does adds it once, at file scope:
+//
+//   XINPUT_ANALOG_ISR()
+//
+// Without it, begin() fails to link on AVR.
+class XInputAnalog {
+public:
+	XInputAnalog();
+
+	// Add the inputs before begin(), each returns 'false' if it won't fit.
+	// Inverting is done on the raw reading, so it doesn't depend on the
+	// controller's input range
+	boolean addTrigger(XInputControl trigger, uint8_t pin, boolean invert=false);
+	boolean addJoystick(XInputControl joy, uint8_t pinX, uint8_t pinY, boolean invertX=false, boolean invertY=false);
+
+	void setSamples(uint8_t samples);  // Conversions averaged per value, power of 2 from 1 to 64
+	uint8_t getSamples() const;
+
+	void begin(XInputController& controller=XInput);  // Start sampling, stops any other running XInputAnalog
+	void end();  // Stop sampling, so analogRead() works again
+
+	void update();  // Sets the controller's inputs if new values are ready, call once per loop
+
+	uint8_t getChannels() const;
+	uint16_t getValue(uint8_t channel) const;  // Latest averaged value, 0-1023, in the order added
+
+	void sampleComplete(uint16_t value);  // Called by the ADC interrupt
+
+	static void interrupt();  // ADC interrupt handler, see XINPUT_ANALOG_ISR()
+	static void interruptDefined();  // Defined by XINPUT_ANALOG_ISR()
+
+	static constexpr uint8_t MaxChannels = 6;  // Two joysticks and two triggers
+	static constexpr uint16_t AnalogMax = 1023;  // 10 bit
+
+private:
+	struct Channel {
+		uint8_t pin;
+		uint8_t mux;  // ADC channel, bit 3 for MUX5
+		XInputControl control;  // Joysticks are two channels in a row, X then Y
+		boolean invert;
+	};
+
+	XInputController * controller;  // nullptr if stopped
+	Channel channels[MaxChannels];
+	uint8_t numChannels;
+	uint8_t sampleShift;  // log2 of the number of samples
+
+	// Written by the interrupt while running
+	uint8_t converting;  // Channel of the conversion in progress
+	uint8_t selected;  // Channel selected for the conversion after it
+	uint8_t pass;  // Passes over every channel this sweep
+	uint16_t sums[MaxChannels];
+	volatile uint16_t values[MaxChannels];  // Published averages
+	volatile uint8_t sequence;  // Incremented before and after writing the above, odd while writing
+
+	uint8_t lastSequence;  // Sequence of the values last passed to the controller
+
+	boolean addChannel(uint8_t pin, XInputControl control, boolean invert);
+	void publish();
+	void read(uint16_t * out, uint8_t& seq) const;  // Consistent copy of the values
+	static uint8_t pinToMux(uint8_t pin);
+	static void selectChannel(uint8_t mux);
+};
+
+#if defined(__AVR__)
+#define XINPUT_ANALOG_ISR() \
+	ISR(ADC_vect) { XInputAnalog::interrupt(); } \
+	void XInputAnalog::interruptDefined() {}
+#else
+#define XINPUT_ANALOG_ISR()  // No interrupt, sampled from update()
+#endif
+
+#endif  // XINPUT_ANALOG
+
+#endif
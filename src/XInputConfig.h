@@ -0,0 +1,150 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputConfig_h
+#define XInputConfig_h
+
+// --------------------------------------------------------
+// XInput Feature Switches                                |
+// --------------------------------------------------------
+
+// Each feature below can be compiled out to save flash and RAM, by setting
+// it to 0 here or with a build flag (e.g. -DXINPUT_DEBUG_PRINT=0). A disabled
+// feature's functions are removed from the API, and its code and data are
+// not built. 'extras/SizeReport' measures what each one costs.
+
+// printDebug(), and the debug output on boards without XInput support
+#ifndef XINPUT_DEBUG_PRINT
+#define XINPUT_DEBUG_PRINT 1
+#endif
+
+// printTelemetry(), compact binary frames of the report for debugging
+#ifndef XINPUT_TELEMETRY
+#define XINPUT_TELEMETRY 1
+#endif
+
+// XInputRecorder, recording of the sent reports for playback
+#ifndef XINPUT_RECORDER
+#define XINPUT_RECORDER 1
+#endif
+
+// setRange() and friends. If disabled, inputs are taken in the output
+// ranges (TriggerRange and JoystickRange) and clipped
+#ifndef XINPUT_INPUT_RANGES
+#define XINPUT_INPUT_RANGES 1
+#endif
+
+// Deadzones and response curves, setDeadzone() and friends
+#ifndef XINPUT_INPUT_PROCESSING
+#define XINPUT_INPUT_PROCESSING 1
+#endif
+
+// SOCD cleaning for the digital setDpad() and setJoystick() functions.
+// If disabled, their 'useSOCD' argument is ignored
+#ifndef XINPUT_SOCD
+#define XINPUT_SOCD 1
+#endif
+
+// setDebounce(), filtering of the button inputs
+#ifndef XINPUT_DEBOUNCE
+#define XINPUT_DEBOUNCE 1
+#endif
+
+// XInputRumble, driving the rumble motors from PWM pins
+#ifndef XINPUT_RUMBLE
+#define XINPUT_RUMBLE 1
+#endif
+
+// Renders XInputRumble from a ~1 kHz hardware timer interrupt (Timer0
+// compare B on AVR, IntervalTimer on Teensy) instead of from update().
+// Disabled by default, as it claims the interrupt for the whole sketch
+#ifndef XINPUT_RUMBLE_TIMER
+#define XINPUT_RUMBLE_TIMER 0
+#endif
+
+// XInputAnalog, sampling the joysticks and triggers from the ADC interrupt
+// on AVR. The interrupt is only defined by sketches that use it, with
+// XINPUT_ANALOG_ISR()
+#ifndef XINPUT_ANALOG
+#define XINPUT_ANALOG 1
+#endif
+
+// XInputInterruptButtons, setting buttons from pin interrupts. Every
+// setter and send() then marks the report busy while it runs, so it's
+// disabled by default
+#ifndef XINPUT_INTERRUPT_BUTTONS
+#define XINPUT_INTERRUPT_BUTTONS 0
+#endif
+
+// XInputPins, reading buttons from a table of pin bindings
+#ifndef XINPUT_PIN_TABLE
+#define XINPUT_PIN_TABLE 1
+#endif
+
+// XInputMacros, turbo buttons and macro playback
+#ifndef XINPUT_MACROS
+#define XINPUT_MACROS 1
+#endif
+
+// setReceiveCallback(), and deferred receive
+#ifndef XINPUT_RECV_CALLBACK
+#define XINPUT_RECV_CALLBACK 1
+#endif
+
+// LED packet parsing, getPlayer() and getLEDPattern()
+#ifndef XINPUT_LED_PARSING
+#define XINPUT_LED_PARSING 1
+#endif
+
+// XInputLEDs, showing the LED patterns on up to four LEDs. Needs the
+// LED packet parsing above
+#ifndef XINPUT_LED_ANIMATION
+#define XINPUT_LED_ANIMATION XINPUT_LED_PARSING
+#endif
+
+#if XINPUT_LED_ANIMATION && !XINPUT_LED_PARSING
+	#error "XINPUT_LED_ANIMATION needs XINPUT_LED_PARSING"
+#endif
+
+// Report encoder, the wire format send() writes. The XInput (Xbox 360)
+// report is the library's own layout and is sent as is. The others are
+// encoded from it on send, and need a USB backend for that interface.
+// See XInputEncoder.h
+#define XINPUT_ENCODER_360 0  // Xbox 360 XInput, 20 bytes
+#define XINPUT_ENCODER_HID 1  // Generic HID gamepad, 13 bytes
+#define XINPUT_ENCODER_GIP 2  // Xbox One GIP input report, 18 bytes
+
+#ifndef XINPUT_ENCODER
+#define XINPUT_ENCODER XINPUT_ENCODER_360
+#endif
+
+// Send / receive statistics, see XInputController::getStats(). Adds a
+// little RAM and time to every call, so it's disabled by default
+#ifndef XINPUT_STATS
+#define XINPUT_STATS 0
+#endif
+
+#endif
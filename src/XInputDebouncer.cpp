@@ -0,0 +1,119 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputDebouncer.h"
+
+#if XINPUT_DEBOUNCE
+
+constexpr uint8_t XInputDebouncer::MaxDepth;
+
+XInputDebouncer::XInputDebouncer() : eager(false) {
+	setDepth(4);
+	reset();
+}
+
+void XInputDebouncer::reset(uint16_t s) {
+	state = s;
+
+	// Integrating counts start at zero, eager counts start settled
+	for (uint8_t i = 0; i < 3; i++) {
+		count[i] = eager ? depthBits[i] : 0x0000;
+	}
+}
+
+void XInputDebouncer::setDepth(uint8_t d) {
+	if (d < 1) d = 1;
+	if (d > MaxDepth) d = MaxDepth;
+	depth = d;
+
+	for (uint8_t i = 0; i < 3; i++) {
+		depthBits[i] = (depth & (1 << i)) ? 0xFFFF : 0x0000;
+	}
+	reset(state);
+}
+
+void XInputDebouncer::setEager(boolean e) {
+	eager = e;
+	reset(state);
+}
+
+uint8_t XInputDebouncer::getDepth() const {
+	return depth;
+}
+
+boolean XInputDebouncer::getEager() const {
+	return eager;
+}
+
+uint16_t XInputDebouncer::getState() const {
+	return state;
+}
+
+uint16_t XInputDebouncer::sample(uint16_t raw) {
+	const uint16_t delta = raw ^ state;  // Bits that differ from the output
+
+	if (!eager) {
+		// Count consecutive samples that differ, restarting on any that match
+		for (uint8_t i = 0; i < 3; i++) {
+			count[i] &= delta;
+		}
+		increment(delta);
+
+		const uint16_t toggle = delta & reached();
+		state ^= toggle;
+		for (uint8_t i = 0; i < 3; i++) {
+			count[i] &= ~toggle;
+		}
+	}
+	else {
+		// Count samples since the last change, holding once settled
+		const uint16_t settled = reached();
+		const uint16_t toggle = delta & settled;
+		state ^= toggle;
+
+		increment(~settled);
+		for (uint8_t i = 0; i < 3; i++) {
+			count[i] &= ~toggle;
+		}
+	}
+
+	return state;
+}
+
+void XInputDebouncer::increment(uint16_t mask) {
+	uint16_t carry = mask;
+	for (uint8_t i = 0; i < 3; i++) {
+		const uint16_t next = count[i] & carry;
+		count[i] ^= carry;
+		carry = next;
+	}
+}
+
+uint16_t XInputDebouncer::reached() const {
+	return ~((count[0] ^ depthBits[0]) | (count[1] ^ depthBits[1]) | (count[2] ^ depthBits[2]));
+}
+
+#endif  // XINPUT_DEBOUNCE
@@ -0,0 +1,80 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputDebouncer_h
+#define XInputDebouncer_h
+
+#include <Arduino.h>
+
+#include "XInputConfig.h"
+
+#if XINPUT_DEBOUNCE
+
+// --------------------------------------------------------
+// XInput Button Debouncer                                |
+// (Bit-sliced integrators for all 16 button bits)        |
+// --------------------------------------------------------
+
+// Filters a 16-bit word of button states, one bit per button, with a
+// 3-bit counter per bit. The counters are stored "vertically" (bit 'n' of
+// each counter word belongs to button 'n'), so every button is filtered
+// at once with a handful of bitwise operations per sample.
+//
+// In integrating mode a button changes state once it has read the new
+// state for 'depth' samples in a row. In eager mode a change passes
+// through immediately, and the button then ignores changes until it has
+// been stable for 'depth' samples.
+
+class XInputDebouncer {
+public:
+	XInputDebouncer();
+
+	void reset(uint16_t state=0);  // Sets the output, with every button settled
+
+	void setDepth(uint8_t depth);  // Samples, 1-7
+	void setEager(boolean eager);
+	uint8_t getDepth() const;
+	boolean getEager() const;
+
+	uint16_t sample(uint16_t raw);  // Adds a sample, returns the filtered state
+	uint16_t getState() const;
+
+	static constexpr uint8_t MaxDepth = 7;  // Largest 3-bit count
+
+private:
+	uint16_t state;  // Filtered output
+	uint16_t count[3];  // Vertical counters, bit 0 to bit 2
+	uint16_t depthBits[3];  // 'depth' spread across all bits, for comparing
+	uint8_t depth;
+	boolean eager;
+
+	void increment(uint16_t mask);  // Adds one to the counters for the bits in 'mask'
+	uint16_t reached() const;  // Bits whose count equals 'depth'
+};
+
+#endif  // XINPUT_DEBOUNCE
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputEncoder.h"
+#include "XInput.h"
+
+constexpr uint8_t XInputEncoder360::MessageType;
+constexpr uint8_t XInputEncoder360::ReportSize;
+constexpr uint8_t XInputEncoderHID::ReportSize;
+constexpr uint8_t XInputEncoderGIP::ReportSize;
+
+static void writeWord(uint8_t * out, uint16_t val) {
+	out[0] = lowByte(val);  // Little endian
+	out[1] = highByte(val);
+}
+
+// Moves the buttons from the XInput button word to the encoder's, by a
+// table of controls in the order of the encoder's bits
+static uint16_t mapButtons(uint16_t buttons, const XInputControl * map, uint8_t length) {
+	uint16_t out = 0x0000;
+	for (uint8_t i = 0; i < length; i++) {
+		if (buttons & XInputMap::buttonMask(map[i])) out |= (1 << i);
+	}
+	return out;
+}
+
+// --------------------------------------------------------
+// Generic HID Gamepad                                    |
+// --------------------------------------------------------
+
+const uint8_t XInputEncoderHID::ReportDescriptor[] PROGMEM = {
+	0x05, 0x01,        // Usage Page (Generic Desktop)
+	0x09, 0x05,        // Usage (Game Pad)
+	0xA1, 0x01,        // Collection (Application)
+
+	0x05, 0x09,        //   Usage Page (Button)
+	0x19, 0x01,        //   Usage Minimum (1)
+	0x29, 0x10,        //   Usage Maximum (16)
+	0x15, 0x00,        //   Logical Minimum (0)
+	0x25, 0x01,        //   Logical Maximum (1)
+	0x75, 0x01,        //   Report Size (1)
+	0x95, 0x10,        //   Report Count (16)
+	0x81, 0x02,        //   Input (Data, Var, Abs)
+
+	0x05, 0x01,        //   Usage Page (Generic Desktop)
+	0x09, 0x39,        //   Usage (Hat Switch)
+	0x15, 0x00,        //   Logical Minimum (0)
+	0x25, 0x07,        //   Logical Maximum (7)
+	0x35, 0x00,        //   Physical Minimum (0)
+	0x46, 0x3B, 0x01,  //   Physical Maximum (315)
+	0x65, 0x14,        //   Unit (Degrees)
+	0x75, 0x04,        //   Report Size (4)
+	0x95, 0x01,        //   Report Count (1)
+	0x81, 0x42,        //   Input (Data, Var, Abs, Null State)
+	0x65, 0x00,        //   Unit (None)
+	0x45, 0x00,        //   Physical Maximum (0)
+	0x81, 0x03,        //   Input (Const), 4 bit pad
+
+	0x09, 0x33,        //   Usage (Rx)
+	0x09, 0x34,        //   Usage (Ry)
+	0x26, 0xFF, 0x00,  //   Logical Maximum (255)
+	0x75, 0x08,        //   Report Size (8)
+	0x95, 0x02,        //   Report Count (2)
+	0x81, 0x02,        //   Input (Data, Var, Abs)
+
+	0x09, 0x30,        //   Usage (X)
+	0x09, 0x31,        //   Usage (Y)
+	0x09, 0x32,        //   Usage (Z)
+	0x09, 0x35,        //   Usage (Rz)
+	0x16, 0x00, 0x80,  //   Logical Minimum (-32768)
+	0x26, 0xFF, 0x7F,  //   Logical Maximum (32767)
+	0x75, 0x10,        //   Report Size (16)
+	0x95, 0x04,        //   Report Count (4)
+	0x81, 0x02,        //   Input (Data, Var, Abs)
+
+	0xC0,              // End Collection
+};
+
+const uint8_t XInputEncoderHID::ReportDescriptorSize = sizeof(XInputEncoderHID::ReportDescriptor);
+
+static constexpr XInputControl XInputEncoderHID_Buttons[] = {
+	BUTTON_A, BUTTON_B, BUTTON_X, BUTTON_Y, BUTTON_LB, BUTTON_RB,
+	BUTTON_BACK, BUTTON_START, BUTTON_L3, BUTTON_R3, BUTTON_LOGO,
+};
+
+// Indexed by the D-pad bits (up, down, left, right). Opposing directions
+// cancel out
+static constexpr uint8_t XInputEncoderHID_Hat[16] = {
+	8, 0, 4, 8,  // None, U, D, UD
+	6, 7, 5, 6,  // L, UL, DL, UDL
+	2, 1, 3, 2,  // R, UR, DR, UDR
+	8, 0, 4, 8,  // LR, ULR, DLR, UDLR
+};
+
+const uint8_t * XInputEncoderHID::encode(const XInputReport & report) {
+	const uint16_t buttons = report.getButtons();
+	writeWord(buffer, mapButtons(buttons, XInputEncoderHID_Buttons, sizeof(XInputEncoderHID_Buttons)));
+	buffer[2] = XInputEncoderHID_Hat[buttons & 0x0F];  // D-pad is the low nibble
+
+	buffer[3] = report.triggers[0];
+	buffer[4] = report.triggers[1];
+
+	for (uint8_t i = 0; i < 4; i++) {
+		int16_t val = report.getAxis(i);
+		if (i & 1) val = (val == -32768) ? 32767 : -val;  // Y axes are down on HID
+		writeWord(buffer + 5 + (i * 2), val);
+	}
+
+	return buffer;
+}
+
+// --------------------------------------------------------
+// Xbox One GIP                                           |
+// --------------------------------------------------------
+
+// Bit order of the GIP button word, from bit 2
+static constexpr XInputControl XInputEncoderGIP_Buttons[] = {
+	BUTTON_START, BUTTON_BACK, BUTTON_A, BUTTON_B, BUTTON_X, BUTTON_Y,
+	DPAD_UP, DPAD_DOWN, DPAD_LEFT, DPAD_RIGHT,
+	BUTTON_LB, BUTTON_RB, BUTTON_L3, BUTTON_R3,
+};
+
+const uint8_t * XInputEncoderGIP::encode(const XInputReport & report) {
+	if (++sequence == 0) sequence = 1;  // 0 is never sent
+
+	buffer[0] = 0x20;  // Input report
+	buffer[1] = 0x00;
+	buffer[2] = sequence;
+	buffer[3] = ReportSize - 4;
+
+	writeWord(buffer + 4, mapButtons(report.getButtons(), XInputEncoderGIP_Buttons, sizeof(XInputEncoderGIP_Buttons)) << 2);
+
+	for (uint8_t i = 0; i < 2; i++) {
+		const uint8_t val = report.triggers[i];
+		writeWord(buffer + 6 + (i * 2), (val << 2) | (val >> 6));  // 8 to 10 bit, 255 is 1023
+	}
+
+	for (uint8_t i = 0; i < 4; i++) {
+		writeWord(buffer + 10 + (i * 2), report.getAxis(i));
+	}
+
+	return buffer;
+}
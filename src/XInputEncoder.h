@@ -0,0 +1,109 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputEncoder_h
+#define XInputEncoder_h
+
+#include <Arduino.h>
+
+#include "XInputConfig.h"
+
+struct XInputReport;
+
+// --------------------------------------------------------
+// XInput Report Encoders                                 |
+// --------------------------------------------------------
+
+// The controller keeps its state in the Xbox 360 report (XInputReport),
+// and the encoder chosen by XINPUT_ENCODER turns that into the report for
+// the host. Each encoder owns its wire layout and its button map, and
+// writes straight into its own endpoint buffer, which is passed to the
+// backend as is.
+//
+//   ReportSize             Bytes sent per report
+//   encode(report)         Writes the buffer, returns a pointer to it
+
+// Xbox 360 XInput. The controller's state is already in this layout, so
+// it's sent in place and there's nothing to encode.
+struct XInputEncoder360 {
+	static constexpr uint8_t MessageType = 0x00;
+	static constexpr uint8_t ReportSize = 20;
+};
+
+// Generic HID gamepad, no report ID. See ReportDescriptor.
+//   [0..1]   Buttons 1-11: A, B, X, Y, LB, RB, Back, Start, L3, R3, Logo
+//   [2]      Hat switch (low nibble), 0-7 clockwise from up, 8 centered
+//   [3..4]   Triggers (Rx, Ry), 0-255
+//   [5..12]  Joysticks (X, Y, Z, Rz), int16_t little endian, Y down
+class XInputEncoderHID {
+public:
+	static constexpr uint8_t ReportSize = 13;
+
+	static const uint8_t ReportDescriptor[] PROGMEM;
+	static const uint8_t ReportDescriptorSize;
+
+	XInputEncoderHID() : buffer() {}
+
+	const uint8_t * encode(const XInputReport & report);
+
+private:
+	uint8_t buffer[ReportSize];
+};
+
+// Xbox One GIP input report (command 0x20). The guide button is a
+// separate GIP message and isn't sent.
+//   [0]      Command (0x20)
+//   [1]      Flags (0x00)
+//   [2]      Sequence, 1-255
+//   [3]      Payload length (14)
+//   [4..5]   Buttons, little endian: Menu, View, A, B, X, Y from bit 2,
+//            D-pad up, down, left, right, LB, RB, L3, R3 from bit 8
+//   [6..9]   Triggers, uint16_t little endian, 0-1023
+//   [10..17] Joysticks (LX, LY, RX, RY), int16_t little endian, Y up
+class XInputEncoderGIP {
+public:
+	static constexpr uint8_t ReportSize = 18;
+
+	XInputEncoderGIP() : buffer(), sequence(0) {}
+
+	const uint8_t * encode(const XInputReport & report);
+
+private:
+	uint8_t buffer[ReportSize];
+	uint8_t sequence;  // Of the last report, 0 before the first
+};
+
+#if XINPUT_ENCODER == XINPUT_ENCODER_360
+using XInputEncoder = XInputEncoder360;
+#elif XINPUT_ENCODER == XINPUT_ENCODER_HID
+using XInputEncoder = XInputEncoderHID;
+#elif XINPUT_ENCODER == XINPUT_ENCODER_GIP
+using XInputEncoder = XInputEncoderGIP;
+#else
+	#error "Unknown XINPUT_ENCODER"
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputInterruptButtons.h"
+
+#if XINPUT_INTERRUPT_BUTTONS
+
+constexpr uint8_t XInputInterruptButtons::MaxPins;
+
+// --------------------------------------------------------
+// XInput Pin Interrupts                                  |
+// --------------------------------------------------------
+
+static XInputInterruptButtons * XInputInterruptButtons_Active = nullptr;  // Only one can own the interrupts
+
+// attachInterrupt() doesn't pass the pin, so each slot gets its own handler
+template<uint8_t Index>
+static void XInputInterruptButtons_ISR() {
+	if (XInputInterruptButtons_Active != nullptr) XInputInterruptButtons_Active->pinChanged(Index);
+}
+
+using XInputInterruptButtons_Handler = void(*)(void);
+
+static const XInputInterruptButtons_Handler XInputInterruptButtons_Handlers[XInputInterruptButtons::MaxPins] = {
+	XInputInterruptButtons_ISR<0>,  XInputInterruptButtons_ISR<1>,  XInputInterruptButtons_ISR<2>,  XInputInterruptButtons_ISR<3>,
+	XInputInterruptButtons_ISR<4>,  XInputInterruptButtons_ISR<5>,  XInputInterruptButtons_ISR<6>,  XInputInterruptButtons_ISR<7>,
+	XInputInterruptButtons_ISR<8>,  XInputInterruptButtons_ISR<9>,  XInputInterruptButtons_ISR<10>, XInputInterruptButtons_ISR<11>,
+	XInputInterruptButtons_ISR<12>, XInputInterruptButtons_ISR<13>, XInputInterruptButtons_ISR<14>, XInputInterruptButtons_ISR<15>,
+};
+
+// --------------------------------------------------------
+// XInput Interrupt Buttons                               |
+// --------------------------------------------------------
+
+XInputInterruptButtons::XInputInterruptButtons() :
+	controller(nullptr), pins(), numPins(0), mask(0x0000),
+	buttons(0x0000), resendInterval(1000), lastSend(0)
+{}
+
+boolean XInputInterruptButtons::add(XInputControl button, uint8_t pin, boolean activeLow) {
+	if (controller != nullptr) return false;  // Error: Already running
+	if (numPins >= MaxPins) return false;  // Error: Full
+	if (XInputMap::isJoystick(button) || !XInputMap::isButton(button)) return false;  // Error: Not a button
+
+	Pin & p = pins[numPins++];
+	p.pin = pin;
+	p.activeLow = activeLow;
+	p.mask = XInputMap::buttonMask(button);
+#ifdef NOT_AN_INTERRUPT
+	p.interrupt = digitalPinToInterrupt(pin) != NOT_AN_INTERRUPT;
+#else
+	p.interrupt = true;
+#endif
+
+	mask |= p.mask;
+	return true;
+}
+
+void XInputInterruptButtons::setResendInterval(uint16_t interval) {
+	resendInterval = interval;
+}
+
+void XInputInterruptButtons::begin(XInputController& c) {
+	end();
+	if (XInputInterruptButtons_Active != nullptr) XInputInterruptButtons_Active->end();
+
+	for (uint8_t i = 0; i < numPins; i++) {
+		pinMode(pins[i].pin, pins[i].activeLow ? INPUT_PULLUP : INPUT);
+	}
+
+	controller = &c;
+	lastSend = micros() - resendInterval;  // The first change can send at once
+	update();  // Starting state
+
+	XInputInterruptButtons_Active = this;
+	for (uint8_t i = 0; i < numPins; i++) {
+		if (!pins[i].interrupt) continue;
+		attachInterrupt(digitalPinToInterrupt(pins[i].pin), XInputInterruptButtons_Handlers[i], CHANGE);
+	}
+}
+
+void XInputInterruptButtons::end() {
+	if (controller == nullptr) return;  // Not running
+
+	for (uint8_t i = 0; i < numPins; i++) {
+		if (!pins[i].interrupt) continue;
+		detachInterrupt(digitalPinToInterrupt(pins[i].pin));
+	}
+	XInputInterruptButtons_Active = nullptr;
+	controller = nullptr;
+}
+
+void XInputInterruptButtons::update() {
+	if (controller == nullptr) return;  // Not running
+
+	uint16_t b = 0x0000;
+	for (uint8_t i = 0; i < numPins; i++) {
+		if (read(i)) b |= pins[i].mask;
+	}
+	buttons = b;
+
+	controller->setButtonsFromInterrupt(b, mask, false);  // Sent by the sketch's send()
+}
+
+uint16_t XInputInterruptButtons::getButtons() const {
+	return buttons;
+}
+
+uint8_t XInputInterruptButtons::getPins() const {
+	return numPins;
+}
+
+uint8_t XInputInterruptButtons::getInterruptPins() const {
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < numPins; i++) {
+		if (pins[i].interrupt) count++;
+	}
+	return count;
+}
+
+void XInputInterruptButtons::pinChanged(uint8_t index) {
+	if (controller == nullptr || index >= numPins) return;  // Error: Not running, or not a pin
+
+	const Pin & p = pins[index];
+	const uint16_t state = read(index) ? p.mask : 0x0000;
+
+	const uint32_t now = micros();
+	const boolean sendNow = (now - lastSend >= resendInterval);
+	if (controller->setButtonsFromInterrupt(state, p.mask, sendNow) == XInputInterruptResult::Sent) {
+		lastSend = now;  // Not when busy, so the next change can still go out at once
+	}
+}
+
+boolean XInputInterruptButtons::read(uint8_t index) const {
+	return (digitalRead(pins[index].pin) == LOW) == pins[index].activeLow;
+}
+
+#endif  // XINPUT_INTERRUPT_BUTTONS
@@ -0,0 +1,95 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputInterruptButtons_h
+#define XInputInterruptButtons_h
+
+#include "XInput.h"
+
+#if XINPUT_INTERRUPT_BUTTONS
+
+// --------------------------------------------------------
+// XInput Interrupt Buttons                               |
+// --------------------------------------------------------
+
+// Sets buttons from pin change interrupts, so a press reaches the report
+// as soon as the pin changes rather than on the next pass of the loop.
+// If the endpoint is free the report is sent straight from the interrupt,
+// at most once per resend interval; otherwise it goes out with the next
+// send(). See XInputController::setButtonsFromInterrupt() for when the
+// interrupt has to leave it to the loop.
+//
+// Pins without an interrupt (see digitalPinToInterrupt(), e.g. only pins
+// 0-3 and 7 on the Leonardo) are read by update() instead. update() also
+// re-reads the interrupt pins, so a change the interrupt couldn't apply
+// is never lost. The buttons bound here shouldn't also be set by the
+// sketch.
+class XInputInterruptButtons {
+public:
+	XInputInterruptButtons();
+
+	// Add the pins before begin(), returns 'false' if it won't fit or the
+	// control isn't a button
+	boolean add(XInputControl button, uint8_t pin, boolean activeLow=true);
+
+	void setResendInterval(uint16_t interval);  // Min time between sends from the interrupt, us
+
+	void begin(XInputController& controller=XInput);  // Sets the pin modes and attaches the interrupts
+	void end();  // Detaches the interrupts
+
+	void update();  // Reads every pin and sets the buttons, call once per loop
+
+	uint16_t getButtons() const;  // Bound buttons pressed as of the last update(), per XInputMap::buttonMask
+	uint8_t getPins() const;
+	uint8_t getInterruptPins() const;  // Pins with an interrupt
+
+	void pinChanged(uint8_t index);  // Called by the pin interrupts
+
+	static constexpr uint8_t MaxPins = 16;  // Every button
+
+private:
+	struct Pin {
+		uint8_t pin;
+		boolean activeLow;
+		boolean interrupt;  // Attached to an interrupt, otherwise polled
+		uint16_t mask;  // Button bit
+	};
+
+	XInputController * controller;  // nullptr if stopped
+	Pin pins[MaxPins];
+	uint8_t numPins;
+	uint16_t mask;  // Every bound button
+
+	uint16_t buttons;  // Pressed, as of the last update()
+	uint16_t resendInterval;
+	uint32_t lastSend;  // Time an interrupt last sent, us
+
+	boolean read(uint8_t index) const;  // Returns 'true' if pressed
+};
+
+#endif  // XINPUT_INTERRUPT_BUTTONS
+
+#endif
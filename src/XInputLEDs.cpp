@@ -0,0 +1,182 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputLEDs.h"
+
+#if XINPUT_LED_ANIMATION
+
+// --------------------------------------------------------
+// XInput LED Pattern Tables                              |
+// --------------------------------------------------------
+
+struct XInputLED_Step {
+	uint8_t leds;  // Bits 0-3 for LEDs 1-4, plus 'PlayerLED'
+	uint8_t time;  // In 10 ms units, 0 to hold
+};
+
+struct XInputLED_Pattern {
+	uint8_t first;  // Index of the first step
+	uint8_t steps;  // Number of steps
+	uint8_t repeats;  // Times to play before the player indicator, 0 for forever
+};
+
+static constexpr uint8_t PlayerLED = 0x10;  // The LED of the assigned player, if any
+
+static const XInputLED_Step XInputLED_Steps[] = {
+	{ 0x00,  0 },                                      //  0: Off
+	{ 0x0F, 25 }, { 0x00, 25 },                        //  1: Blinking, all four
+	{ 0x01, 10 }, { 0x00, 10 },                        //  3: Flash 1
+	{ 0x02, 10 }, { 0x00, 10 },                        //  5: Flash 2
+	{ 0x04, 10 }, { 0x00, 10 },                        //  7: Flash 3
+	{ 0x08, 10 }, { 0x00, 10 },                        //  9: Flash 4
+	{ 0x01,  0 },                                      // 11: On 1
+	{ 0x02,  0 },                                      // 12: On 2
+	{ 0x04,  0 },                                      // 13: On 3
+	{ 0x08,  0 },                                      // 14: On 4
+	{ 0x01, 10 }, { 0x02, 10 }, { 0x08, 10 }, { 0x04, 10 },  // 15: Rotating, clockwise
+	{ 0x00, 25 },                                      // 19: Blink once, player LED off
+	{ PlayerLED, 50 }, { 0x00, 50 },                   // 20: Blink slow, player LED
+	{ 0x09, 25 }, { 0x06, 25 },                        // 22: Alternating, 1+4 and 2+3
+	{ PlayerLED, 0 },                                  // 24: Player indicator
+};
+
+static const XInputLED_Pattern XInputLED_Patterns[] = {
+	{  0, 1, 0 },  // Off
+	{  1, 2, 0 },  // Blinking
+	{  3, 2, 3 },  // Flash1
+	{  5, 2, 3 },  // Flash2
+	{  7, 2, 3 },  // Flash3
+	{  9, 2, 3 },  // Flash4
+	{ 11, 1, 0 },  // On1
+	{ 12, 1, 0 },  // On2
+	{ 13, 1, 0 },  // On3
+	{ 14, 1, 0 },  // On4
+	{ 15, 4, 0 },  // Rotating
+	{ 19, 1, 1 },  // BlinkOnce
+	{ 20, 2, 0 },  // BlinkSlow
+	{ 22, 2, 4 },  // Alternating
+	{ 24, 1, 0 },  // Player indicator, after the patterns that end
+};
+
+static constexpr uint8_t PlayerIndicator = sizeof(XInputLED_Patterns) / sizeof(XInputLED_Patterns[0]) - 1;
+
+// --------------------------------------------------------
+// XInput Player LEDs                                     |
+// --------------------------------------------------------
+
+constexpr uint8_t XInputLEDs::NoPin;
+
+XInputLEDs::XInputLEDs(uint8_t pin1, uint8_t pin2, uint8_t pin3, uint8_t pin4) :
+	controller(nullptr), pins{ pin1, pin2, pin3, pin4 },
+	pattern(0), hostPattern(0), player(0), step(0), repeat(0), stepStart(0), leds(0)
+{}
+
+void XInputLEDs::begin(XInputController& c) {
+	for (uint8_t i = 0; i < 4; i++) {
+		if (pins[i] != NoPin) pinMode(pins[i], OUTPUT);
+	}
+	write(0x00);
+
+	controller = &c;
+	player = c.getPlayer();
+	hostPattern = (uint8_t) c.getLEDPattern();
+	start(hostPattern, millis());
+}
+
+void XInputLEDs::end() {
+	controller = nullptr;
+	write(0x00);
+}
+
+void XInputLEDs::setPattern(XInputLEDPattern p, uint8_t pl) {
+	player = pl;
+	start((uint8_t) p, millis());
+}
+
+void XInputLEDs::update() {
+	update(millis());
+}
+
+void XInputLEDs::update(uint32_t now) {
+	if (controller != nullptr) {
+		const XInputController::RecvData data = controller->getRecvData();
+		player = data.player;
+		if ((uint8_t) data.ledPattern != hostPattern) {  // New pattern from the host
+			hostPattern = (uint8_t) data.ledPattern;
+			start(hostPattern, now);
+		}
+	}
+
+	const XInputLED_Pattern & p = XInputLED_Patterns[pattern];
+	const XInputLED_Step * s = &XInputLED_Steps[p.first + step];
+
+	// At most one step per call, so the time taken is constant
+	if (s->time != 0 && now - stepStart >= (uint32_t) s->time * 10) {
+		stepStart += (uint32_t) s->time * 10;  // From the schedule, so the timing doesn't drift
+
+		if (++step >= p.steps) {
+			step = 0;
+			if (p.repeats != 0 && ++repeat >= p.repeats) {
+				pattern = PlayerIndicator;
+				repeat = 0;
+			}
+		}
+		s = &XInputLED_Steps[XInputLED_Patterns[pattern].first + step];
+		if (now - stepStart >= (uint32_t) s->time * 10) stepStart = now;  // Fell a step behind, resync
+	}
+
+	uint8_t out = s->leds & 0x0F;
+	if ((s->leds & PlayerLED) && player >= 1 && player <= 4) {
+		out |= 1 << (player - 1);
+	}
+	if (out != leds) write(out);
+}
+
+uint8_t XInputLEDs::getLEDs() const {
+	return leds;
+}
+
+void XInputLEDs::start(uint8_t p, uint32_t now) {
+	if (p >= PlayerIndicator) return;  // Error: Not a known pattern
+
+	pattern = p;
+	step = 0;
+	repeat = 0;
+	stepStart = now;
+}
+
+void XInputLEDs::write(uint8_t l) {
+	leds = l;
+
+	const boolean single = (pins[1] == NoPin && pins[2] == NoPin && pins[3] == NoPin);
+	for (uint8_t i = 0; i < 4; i++) {
+		if (pins[i] == NoPin) continue;
+		const boolean on = single ? (l != 0) : (l & (1 << i));
+		digitalWrite(pins[i], on ? HIGH : LOW);
+	}
+}
+
+#endif  // XINPUT_LED_ANIMATION
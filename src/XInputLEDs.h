@@ -0,0 +1,81 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputLEDs_h
+#define XInputLEDs_h
+
+#include "XInput.h"
+
+#if XINPUT_LED_ANIMATION
+
+// --------------------------------------------------------
+// XInput Player LEDs                                     |
+// --------------------------------------------------------
+
+// Shows the host's LED pattern on up to four LEDs, laid out like the ring
+// on a 360 controller: 1 top left, 2 top right, 3 bottom left, 4 bottom
+// right. The patterns are played from a table, one step at a time, so
+// update() takes the same short time whatever the pattern and never
+// waits. Patterns that the 360 controller only shows for a moment (the
+// flashes, 'BlinkOnce' and 'Alternating') fall back to the player's LED
+// when they finish.
+//
+// With only the first pin set, that LED is lit whenever any of the four
+// would be.
+class XInputLEDs {
+public:
+	XInputLEDs(uint8_t pin1, uint8_t pin2=NoPin, uint8_t pin3=NoPin, uint8_t pin4=NoPin);
+
+	void begin(XInputController& controller=XInput);  // Follow the controller's LED pattern
+	void end();  // Stop following the controller, turns the LEDs off
+
+	void setPattern(XInputLEDPattern pattern, uint8_t player);  // Show a pattern without a controller
+	void update();  // Advances the pattern, call once per loop or from a timer
+	void update(uint32_t now);  // As above, with the time in ms
+
+	uint8_t getLEDs() const;  // LEDs lit, bit 0 for LED 1
+
+	static constexpr uint8_t NoPin = 0xFF;
+
+private:
+	XInputController * controller;  // nullptr if not following a controller
+	const uint8_t pins[4];
+
+	uint8_t pattern;  // Table index, XInputLEDPattern or PlayerIndicator
+	uint8_t hostPattern;  // Last pattern read from the controller
+	uint8_t player;
+	uint8_t step;  // Step within the pattern
+	uint8_t repeat;  // Times the pattern has played
+	uint32_t stepStart;  // Time the current step started, in ms
+	uint8_t leds;  // LEDs written to the pins
+
+	void start(uint8_t pattern, uint32_t now);
+	void write(uint8_t leds);
+};
+
+#endif  // XINPUT_LED_ANIMATION
+
+#endif
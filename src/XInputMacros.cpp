@@ -0,0 +1,275 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputMacros.h"
+
+#if XINPUT_MACROS
+
+constexpr uint8_t XInputMacroStep::NoControl;
+constexpr uint8_t XInputMacroEngine::WheelSize;
+constexpr uint8_t XInputMacroEngine::MaxCatchUp;
+constexpr uint8_t XInputMacroEngine::NumTurbo;
+constexpr uint8_t XInputMacroEngine::None;
+constexpr uint8_t XInputMacroEngine::Idle;
+
+// --------------------------------------------------------
+// XInput Macro Engine                                    |
+// --------------------------------------------------------
+
+XInputMacroEngine::XInputMacroEngine(Macro * macros, uint8_t numMacros, uint8_t * links, uint16_t * rounds) :
+	controller(nullptr), macros(macros), numMacros(numMacros), turbo(),
+	links(links), rounds(rounds), cursor(0), tick(0), touched(0)
+{
+	memset(wheel, None, sizeof(wheel));
+	memset(links, Idle, NumTurbo + numMacros);
+	for (uint8_t i = 0; i < numMacros; i++) {
+		macros[i].active = false;
+	}
+}
+
+void XInputMacroEngine::begin(XInputController& c) {
+	end();
+	controller = &c;
+	tick = millis();
+	touched = 0;
+}
+
+void XInputMacroEngine::end() {
+	if (controller == nullptr) return;  // Not running
+
+	stopAll();
+	controller->beginFrame();
+	for (uint8_t i = 0; i < NumTurbo; i++) {
+		Turbo & t = turbo[i];
+		if (t.on) controller->setButton(i, false);
+		t.held = t.on = false;
+	}
+	controller->commit();
+
+	// Clear the wheel
+	memset(wheel, None, sizeof(wheel));
+	memset(links, Idle, NumTurbo + numMacros);
+	controller = nullptr;
+}
+
+void XInputMacroEngine::setTurbo(XInputControl control, uint8_t rate) {
+	if (control >= NumTurbo) return;  // Error: Not a button or trigger
+
+	Turbo & t = turbo[control];
+	if (rate == 0) {
+		t.halfPeriod = 0;  // Taken off the wheel when it next fires
+		if (t.on != t.held && controller != nullptr) controller->setButton(control, t.held);  // Back to the held state
+		t.on = false;
+		return;
+	}
+
+	t.halfPeriod = 500 / rate;  // ms per half cycle
+	if (t.halfPeriod == 0) t.halfPeriod = 1;  // Toggle every tick, 500 Hz max
+	if (t.held && links[control] == Idle) schedule(control, 1);  // Already held, start
+}
+
+void XInputMacroEngine::setButton(XInputControl control, boolean state) {
+	if (controller == nullptr) return;  // Error: Not running
+
+	if (control >= NumTurbo || turbo[control].halfPeriod == 0) {  // No turbo, set as is
+		if (control < NumTurbo) turbo[control].held = state;
+		controller->setButton(control, state);
+		return;
+	}
+
+	Turbo & t = turbo[control];
+	if (t.held == state) return;  // No change
+	t.held = state;
+
+	if (state) {
+		if (links[control] == Idle) schedule(control, 1);  // Press on the next tick
+	}
+	else if (t.on) {
+		t.on = false;
+		controller->setButton(control, false);  // Released at once, the wheel event lapses
+	}
+}
+
+boolean XInputMacroEngine::getTurbo(XInputControl control) const {
+	return control < NumTurbo && turbo[control].halfPeriod != 0;
+}
+
+int8_t XInputMacroEngine::play(const XInputMacroStep * steps, uint8_t length, uint8_t repeat) {
+	if (controller == nullptr || length == 0) return -1;  // Error: Not running, or nothing to play
+
+	for (uint8_t i = 0; i < numMacros; i++) {
+		const uint8_t event = NumTurbo + i;
+		if (macros[i].active || links[event] != Idle) continue;  // Busy, or stopped and still on the wheel
+
+		Macro & m = macros[i];
+		m.steps = steps;
+		m.length = length;
+		m.index = 0;
+		m.remaining = repeat;
+		m.active = true;
+		schedule(event, 1);  // Starts on the next tick
+		return i;
+	}
+	return -1;  // Error: All players are busy
+}
+
+void XInputMacroEngine::stop(int8_t player) {
+	if (player < 0 || player >= numMacros) return;  // Error: Not a player
+	macros[player].active = false;  // Taken off the wheel when it next fires
+}
+
+void XInputMacroEngine::stopAll() {
+	for (uint8_t i = 0; i < numMacros; i++) {
+		macros[i].active = false;
+	}
+}
+
+boolean XInputMacroEngine::playing(int8_t player) const {
+	if (player < 0 || player >= numMacros) return false;  // Error: Not a player
+	return macros[player].active;
+}
+
+uint8_t XInputMacroEngine::getPlaying() const {
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < numMacros; i++) {
+		if (macros[i].active) count++;
+	}
+	return count;
+}
+
+void XInputMacroEngine::update() {
+	update(millis());
+}
+
+void XInputMacroEngine::update(uint32_t now) {
+	if (controller == nullptr) return;  // Not running
+
+	// Runs each tick in order, up to 'now'. A tick with events waits for
+	// the last one's changes to be sent, and if update() falls behind the
+	// ticks are caught up a few at a time.
+	for (uint8_t n = 0; n < MaxCatchUp && (int32_t) (now - tick) > 0; n++) {
+		const uint8_t next = (cursor + 1) % WheelSize;
+		if (wheel[next] != None && !ready()) return;  // Hold the tick until the host has the last one
+
+		cursor = next;
+		tick++;
+		runTick();
+	}
+}
+
+boolean XInputMacroEngine::ready() const {
+	if (controller->sendPending()) return false;  // Endpoint is busy, a change now would replace the pending frame
+	return (controller->getChanges() & touched) == 0;  // Sent
+}
+
+void XInputMacroEngine::schedule(uint8_t event, uint16_t delay) {
+	const uint8_t slot = (cursor + delay) % WheelSize;
+	rounds[event] = (delay - 1) / WheelSize;
+	links[event] = wheel[slot];
+	wheel[slot] = event;
+}
+
+void XInputMacroEngine::runTick() {
+	uint8_t event = wheel[cursor];
+	if (event == None) return;  // Nothing due
+	wheel[cursor] = None;  // Detached, so events can be rescheduled to this slot
+
+	touched = 0;
+	controller->beginFrame();  // Sent as one report
+
+	while (event != None) {
+		const uint8_t next = links[event];
+
+		if (rounds[event] != 0) {  // Not this turn
+			rounds[event]--;
+			links[event] = wheel[cursor];
+			wheel[cursor] = event;
+		}
+		else {
+			links[event] = Idle;
+			if (event < NumTurbo) fireTurbo(event);
+			else fireMacro(event - NumTurbo);
+		}
+		event = next;
+	}
+
+	controller->commit();
+}
+
+void XInputMacroEngine::fireTurbo(uint8_t control) {
+	Turbo & t = turbo[control];
+	if (t.halfPeriod == 0 || !t.held) return;  // Disabled or released, drop it
+
+	t.on = !t.on;
+	controller->setButton(control, t.on);
+	touched |= 1UL << control;
+	schedule(control, t.halfPeriod);
+}
+
+void XInputMacroEngine::fireMacro(uint8_t index) {
+	Macro & m = macros[index];
+	if (!m.active) return;  // Stopped, drop it
+
+	// Steps with no duration are applied with the one after them, at most
+	// one pass of the macro per tick
+	for (uint8_t n = 0; n < m.length; n++) {
+		if (m.index == m.length) {  // Played through
+			if (m.remaining != 0 && --m.remaining == 0) {
+				m.active = false;  // Done
+				return;
+			}
+			m.index = 0;
+		}
+
+		const XInputMacroStep & step = m.steps[m.index++];
+		apply(step);
+		if (step.duration != 0) {
+			schedule(NumTurbo + index, step.duration);
+			return;
+		}
+	}
+	schedule(NumTurbo + index, 1);
+}
+
+void XInputMacroEngine::apply(const XInputMacroStep & step) {
+	const XInputControl ctrl = (XInputControl) step.control;
+
+	if (XInputMap::isJoystick(ctrl)) {
+		controller->setJoystick(ctrl, step.x, step.y);
+	}
+	else if (XInputMap::isTrigger(ctrl)) {
+		controller->setTrigger(ctrl, step.x);
+	}
+	else if (XInputMap::isButton(ctrl)) {
+		controller->setButton(ctrl, step.x != 0);
+	}
+	else {
+		return;  // Wait, or not a control
+	}
+	touched |= 1UL << ctrl;
+}
+
+#endif  // XINPUT_MACROS
@@ -0,0 +1,191 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputMacros_h
+#define XInputMacros_h
+
+#include "XInput.h"
+
+#if XINPUT_MACROS
+
+// --------------------------------------------------------
+// XInput Macro Steps                                     |
+// --------------------------------------------------------
+
+// One step of a macro, declared in a table in the sketch. The control is
+// set and held for 'duration' ms before the next step. Steps with a
+// duration of 0 are applied together with the step after them, in the
+// same report.
+//
+//   const XInputMacroStep Jump[] = {
+//     { BUTTON_A, true, 50 },                // Press A, 50 ms
+//     { BUTTON_A, false, 0 },                // Release A, and...
+//     { JOY_LEFT, 0, 32767, 100 },           // ... push up, 100 ms
+//     { JOY_LEFT, 0, 0, 0 },                 // Center
+//     XInputMacroStep::wait(200),            // Nothing, 200 ms
+//   };
+//
+// Values are in the controller's input ranges, as for setTrigger() and
+// setJoystick().
+struct XInputMacroStep {
+	constexpr XInputMacroStep(XInputControl control, int16_t value, uint16_t duration)
+		: control(control), x(value), y(0), duration(duration) {}  // Button (0 / 1) or trigger
+	constexpr XInputMacroStep(XInputControl joy, int16_t x, int16_t y, uint16_t duration)
+		: control(joy), x(x), y(y), duration(duration) {}  // Joystick
+
+	constexpr static XInputMacroStep wait(uint16_t duration) {
+		return XInputMacroStep(NoControl, duration);
+	}
+
+	static constexpr uint8_t NoControl = 0xFF;
+
+	const uint8_t control;  // XInputControl, or NoControl to wait
+	const int16_t x;  // Button state, trigger value, or joystick X
+	const int16_t y;  // Joystick Y
+	const uint16_t duration;  // ms
+
+private:
+	constexpr XInputMacroStep(uint8_t control, uint16_t duration)
+		: control(control), x(0), y(0), duration(duration) {}
+};
+
+// --------------------------------------------------------
+// XInput Macro Engine                                    |
+// --------------------------------------------------------
+
+// Runs turbo buttons and plays macros on a 1 ms tick. Pending events are
+// kept on a timing wheel, so a tick only touches the events due on it,
+// however many turbos and macros are running.
+//
+// The changes made on a tick are set as one frame, and the next tick with
+// events waits until that frame has been sent (and, with async sending,
+// until the endpoint is free again). So every state reaches the host for
+// at least one poll, however short the step; if the host polls slower
+// than the steps the macro is stretched rather than skipping states.
+//
+// Call update() once per loop before send(), or from the sample callback
+// with poll sync (see XInputController::setSampleCallback()) to apply the
+// steps just ahead of each host poll.
+//
+// Declared as XInputMacros<N>, which holds N macro players.
+class XInputMacroEngine {
+public:
+	XInputMacroEngine(const XInputMacroEngine&) = delete;  // Points into its own storage
+	XInputMacroEngine& operator=(const XInputMacroEngine&) = delete;
+
+	void begin(XInputController& controller=XInput);
+	void end();  // Stops the macros and turbos, releasing the turbo buttons
+
+	// Turbo
+	// While a turbo control is held with setButton() it's pressed and
+	// released 'rate' times a second. Buttons and triggers only.
+	void setTurbo(XInputControl control, uint8_t rate);  // Hz, 0 to disable
+	void setButton(XInputControl control, boolean state);  // Sets the control, with turbo if enabled
+	boolean getTurbo(XInputControl control) const;  // 'true' if turbo is enabled
+
+	// Macros
+	// play() returns the player used, or -1 if they're all busy. The steps
+	// aren't copied and must outlive the macro. 'repeat' is the times to
+	// play it, 0 for forever. A stopped macro leaves the controls as they
+	// are.
+	int8_t play(const XInputMacroStep * steps, uint8_t length, uint8_t repeat);  // No default, so play(table, repeat) can't match it
+	template<uint8_t N> int8_t play(const XInputMacroStep (&steps)[N], uint8_t repeat=1) {
+		return play(steps, N, repeat);
+	}
+	void stop(int8_t player);
+	void stopAll();
+	boolean playing(int8_t player) const;
+	uint8_t getPlaying() const;  // Macros playing
+
+	void update();  // Runs the ticks due, call once per loop
+	void update(uint32_t now);  // As above, with the time in ms
+
+	static constexpr uint8_t WheelSize = 32;  // Ticks per turn of the wheel, longer delays take more turns
+	static constexpr uint8_t MaxCatchUp = WheelSize;  // Most ticks run per update()
+
+protected:
+	struct Macro {
+		const XInputMacroStep * steps;
+		uint8_t length;
+		uint8_t index;  // Next step
+		uint8_t remaining;  // Plays left, 0 for forever
+		boolean active;
+	};
+
+	XInputMacroEngine(Macro * macros, uint8_t numMacros, uint8_t * links, uint16_t * rounds);
+
+	static constexpr uint8_t NumTurbo = TRIGGER_RIGHT + 1;  // Buttons and triggers
+
+private:
+	static constexpr uint8_t None = 0xFF;  // End of a wheel list
+	static constexpr uint8_t Idle = 0xFE;  // Not on the wheel
+
+	struct Turbo {
+		uint16_t halfPeriod;  // Ticks between toggles, 0 if disabled
+		boolean held;  // Set by the sketch
+		boolean on;  // Pressed, as set by the turbo
+	};
+
+	XInputController * controller;  // nullptr if stopped
+	Macro * const macros;
+	const uint8_t numMacros;
+	Turbo turbo[NumTurbo];
+
+	// Timing Wheel
+	// Events are numbered turbo first, by control, then macros. Each one is
+	// on at most one slot's list, linked through 'links'.
+	uint8_t wheel[WheelSize];  // First event on each slot, or None
+	uint8_t * const links;  // Next event on the slot, or Idle, per event
+	uint16_t * const rounds;  // Turns of the wheel left before the event fires, per event
+	uint8_t cursor;  // Slot of 'tick'
+	uint32_t tick;  // Time of the last tick run, ms
+
+	uint32_t touched;  // Controls set on the last tick with events, bit per XInputControl
+
+	boolean ready() const;  // The last tick's changes have been sent
+	void schedule(uint8_t event, uint16_t delay);
+	void runTick();
+	void fireTurbo(uint8_t control);
+	void fireMacro(uint8_t index);
+	void apply(const XInputMacroStep & step);
+};
+
+template<uint8_t NumMacros>
+class XInputMacros : public XInputMacroEngine {
+public:
+	static_assert(NumMacros <= 128, "Too many macros");  // play() returns an int8_t
+
+	XInputMacros() : XInputMacroEngine(macroStorage, NumMacros, linkStorage, roundStorage) {}
+
+private:
+	Macro macroStorage[NumMacros];
+	uint8_t linkStorage[NumTurbo + NumMacros];
+	uint16_t roundStorage[NumTurbo + NumMacros];
+};
+
+#endif  // XINPUT_MACROS
+
+#endif
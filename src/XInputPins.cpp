@@ -0,0 +1,196 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputPins.h"
+
+#if XINPUT_PIN_TABLE
+
+// --------------------------------------------------------
+// XInput Pin Scanner                                     |
+// --------------------------------------------------------
+
+constexpr uint8_t XInputPinScanner::MaxPorts;
+
+XInputPinScanner::XInputPinScanner(const XInputPinBinding * bindings, uint8_t numBindings, Port * ports, uint8_t maxPorts, Bit * bits) :
+	bindings(bindings), numBindings(numBindings), ports(ports), maxPorts(maxPorts), bits(bits),
+	controller(nullptr), numPorts(0), mask(0x0000), buttons(0x0000), triggers(), numTriggers(0)
+#if XINPUT_SOCD
+	, socd(true)
+#endif
+{}
+
+boolean XInputPinScanner::begin(XInputController& c) {
+	numPorts = 0;
+	mask = 0x0000;
+	numTriggers = 0;
+	uint8_t numBits = 0;
+	boolean bound = true;  // Every binding is in the scan
+
+	for (uint8_t i = 0; i < numBindings; i++) {
+		const XInputPinBinding & b = bindings[i];
+		if (XInputMap::isJoystick(b.control)) { bound = false; continue; }  // Error: Not a button, use BUTTON_L3 / BUTTON_R3
+		if (!XInputMap::isButton(b.control) && !XInputMap::isTrigger(b.control)) { bound = false; continue; }  // Error: Not a button
+
+#if defined(__AVR__)
+		const uint8_t port = digitalPinToPort(b.pin);
+		if (port == NOT_A_PIN) { bound = false; continue; }  // Error: No such pin
+#endif
+
+		pinMode(b.pin, b.activeLow ? INPUT_PULLUP : INPUT);
+
+		if (XInputMap::isTrigger(b.control)) {
+			if (numTriggers >= 2) { bound = false; continue; }  // Error: Both triggers are bound
+			Trigger & t = triggers[numTriggers++];
+			t.control = b.control;
+#if defined(__AVR__)
+			t.reg = portInputRegister(port);
+			t.mask = digitalPinToBitMask(b.pin);
+			t.invert = b.activeLow ? t.mask : 0x00;
+#endif
+			continue;
+		}
+
+#if defined(__AVR__)
+		// Pins on a port already seen were added with it
+		volatile uint8_t * const reg = portInputRegister(port);
+		boolean seen = false;
+		for (uint8_t p = 0; p < numPorts; p++) {
+			if (ports[p].reg == reg) { seen = true; break; }
+		}
+		if (seen) continue;
+		if (numPorts >= maxPorts) { bound = false; continue; }  // Error: Out of ports
+
+		Port & p = ports[numPorts++];
+		p.reg = reg;
+		p.invert = 0x00;
+		p.first = numBits;
+		p.count = 0;
+
+		for (uint8_t j = i; j < numBindings; j++) {
+			const XInputPinBinding & o = bindings[j];
+			if (!XInputMap::isButton(o.control) || XInputMap::isJoystick(o.control)) continue;
+			if (digitalPinToPort(o.pin) != port) continue;
+
+			Bit & bit = bits[numBits++];
+			bit.mask = digitalPinToBitMask(o.pin);
+			bit.button = XInputMap::buttonMask(o.control);
+			if (o.activeLow) p.invert |= bit.mask;
+			p.count++;
+			mask |= bit.button;  // Only buttons that are scanned, the rest are left alone
+		}
+#else
+		mask |= XInputMap::buttonMask(b.control);
+#endif
+	}
+	(void) numBits;
+
+	controller = &c;
+	update();  // Starting state
+	return bound;
+}
+
+void XInputPinScanner::end() {
+	controller = nullptr;
+}
+
+void XInputPinScanner::update() {
+	if (controller == nullptr) return;  // Not running
+
+	buttons = scan();
+#if XINPUT_SOCD
+	if (socd) buttons = cleanDpad(buttons);
+#endif
+	controller->setButtons(buttons, mask);
+
+	for (uint8_t i = 0; i < numTriggers; i++) {
+		const Trigger & t = triggers[i];
+#if defined(__AVR__)
+		const boolean pressed = (*t.reg ^ t.invert) & t.mask;
+#else
+		boolean pressed = false;
+		for (uint8_t j = 0; j < numBindings; j++) {
+			if (bindings[j].control == t.control) { pressed = readPin(bindings[j]); break; }
+		}
+#endif
+		controller->setButton(t.control, pressed);
+	}
+}
+
+uint16_t XInputPinScanner::scan() const {
+	uint16_t out = 0x0000;
+
+#if defined(__AVR__)
+	for (uint8_t p = 0; p < numPorts; p++) {
+		const uint8_t val = *ports[p].reg ^ ports[p].invert;  // One read per port
+
+		const Bit * bit = bits + ports[p].first;
+		for (uint8_t n = ports[p].count; n != 0; n--, bit++) {
+			if (val & bit->mask) out |= bit->button;
+		}
+	}
+#else
+	for (uint8_t i = 0; i < numBindings; i++) {
+		const uint16_t button = XInputMap::isJoystick(bindings[i].control) ? 0 : XInputMap::buttonMask(bindings[i].control);
+		if (button != 0 && readPin(bindings[i])) out |= button;
+	}
+#endif
+
+	return out;
+}
+
+#if XINPUT_SOCD
+void XInputPinScanner::setSOCD(boolean s) {
+	socd = s;
+}
+
+uint16_t XInputPinScanner::cleanDpad(uint16_t b) {
+	// Simultaneous Opposite Cardinal Directions (SOCD) Cleaner, as setDpad()
+	constexpr uint16_t UpDown = XInputMap::buttonMask(DPAD_UP) | XInputMap::buttonMask(DPAD_DOWN);
+	constexpr uint16_t LeftRight = XInputMap::buttonMask(DPAD_LEFT) | XInputMap::buttonMask(DPAD_RIGHT);
+
+	if ((b & UpDown) == UpDown) b &= ~XInputMap::buttonMask(DPAD_DOWN);  // Up + Down = Up
+	if ((b & LeftRight) == LeftRight) b &= ~LeftRight;  // Left + Right = Neutral
+	return b;
+}
+#endif
+
+uint16_t XInputPinScanner::getButtons() const {
+	return buttons;
+}
+
+uint16_t XInputPinScanner::getMask() const {
+	return mask;
+}
+
+uint8_t XInputPinScanner::getPorts() const {
+	return numPorts;
+}
+
+boolean XInputPinScanner::readPin(const XInputPinBinding& binding) const {
+	return (digitalRead(binding.pin) == LOW) == binding.activeLow;
+}
+
+#endif  // XINPUT_PIN_TABLE
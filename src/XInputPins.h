@@ -0,0 +1,153 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputPins_h
+#define XInputPins_h
+
+#include "XInput.h"
+
+#if XINPUT_PIN_TABLE
+
+// --------------------------------------------------------
+// XInput Pin Bindings                                    |
+// --------------------------------------------------------
+
+// One digital input, declared in a table in the sketch:
+//
+//   const XInputPinBinding Bindings[] = {
+//     { 2, BUTTON_A },
+//     { 3, BUTTON_B },
+//     { 4, DPAD_UP },
+//     { 5, TRIGGER_LEFT, false },  // Active high, no pull-up
+//   };
+//   XInputPins<4> pins(Bindings);
+struct XInputPinBinding {
+	constexpr XInputPinBinding(uint8_t pin, XInputControl control, boolean activeLow=true)
+		: pin(pin), control(control), activeLow(activeLow) {}
+	const uint8_t pin;
+	const XInputControl control;  // A button, D-pad direction, or trigger (full press)
+	const boolean activeLow;  // Pressed when LOW, using the internal pull-up
+};
+
+// --------------------------------------------------------
+// XInput Pin Scanner                                     |
+// --------------------------------------------------------
+
+// Reads a table of pin bindings and sets the controller's buttons. On AVR
+// begin() sorts the pins by port and works out each one's port mask, so a
+// scan reads each port's input register once and moves the bits straight
+// into the button word, which is then set with one setButtons() call.
+// That's a few cycles per pin, rather than a digitalRead() each. Other
+// boards scan with digitalRead().
+//
+// Opposing D-pad directions are cleaned as setDpad() does (up + down is
+// up, left + right is neutral), unless disabled with setSOCD(false).
+//
+// Declared as XInputPins<N>, which holds the storage for N bindings.
+class XInputPinScanner {
+public:
+	XInputPinScanner(const XInputPinScanner&) = delete;  // Points into its own storage
+	XInputPinScanner& operator=(const XInputPinScanner&) = delete;
+
+	// Sets the pin modes and builds the scan. Returns 'false' if a binding
+	// couldn't be used (not a button, no such pin, or out of ports), the
+	// rest are still scanned and the controls it would have set are left
+	// alone
+	boolean begin(XInputController& controller=XInput);
+	void end();
+
+#if XINPUT_SOCD
+	void setSOCD(boolean socd);  // Clean opposing D-pad directions, on by default
+#endif
+
+	void update();  // Scans the pins and sets the controls, call once per loop
+	uint16_t scan() const;  // Buttons pressed, per XInputMap::buttonMask. Doesn't set anything
+
+	uint16_t getButtons() const;  // As of the last update()
+	uint16_t getMask() const;  // Every button bound to a pin
+	uint8_t getPorts() const;  // Port registers read per scan
+
+protected:
+	struct Port {
+		volatile uint8_t * reg;  // Input register
+		uint8_t invert;  // Active low pins, flipped so that 1 is pressed
+		uint8_t first;  // First bit of this port in 'bits'
+		uint8_t count;
+	};
+
+	struct Bit {
+		uint8_t mask;  // Bit in the port register
+		uint16_t button;  // Bit in the button word
+	};
+
+	XInputPinScanner(const XInputPinBinding * bindings, uint8_t numBindings, Port * ports, uint8_t maxPorts, Bit * bits);
+
+	static constexpr uint8_t MaxPorts = 12;  // Enough for the ATmega2560
+
+private:
+	const XInputPinBinding * const bindings;
+	const uint8_t numBindings;
+	Port * const ports;
+	const uint8_t maxPorts;
+	Bit * const bits;
+
+	XInputController * controller;  // nullptr if stopped
+	uint8_t numPorts;
+	uint16_t mask;
+	uint16_t buttons;
+
+	struct Trigger {
+		XInputControl control;
+		volatile uint8_t * reg;
+		uint8_t mask;
+		uint8_t invert;
+	};
+	Trigger triggers[2];  // Read on their own, they aren't in the button word
+	uint8_t numTriggers;
+
+#if XINPUT_SOCD
+	boolean socd;
+	static uint16_t cleanDpad(uint16_t buttons);
+#endif
+
+	boolean readPin(const XInputPinBinding& binding) const;  // Returns 'true' if pressed
+};
+
+template<uint8_t NumBindings>
+class XInputPins : public XInputPinScanner {
+public:
+	XInputPins(const XInputPinBinding (&bindings)[NumBindings]) :
+		XInputPinScanner(bindings, NumBindings, portStorage, NumPorts, bitStorage) {}
+
+private:
+	static constexpr uint8_t NumPorts = NumBindings < MaxPorts ? NumBindings : MaxPorts;
+	Port portStorage[NumPorts];
+	Bit bitStorage[NumBindings];
+};
+
+#endif  // XINPUT_PIN_TABLE
+
+#endif
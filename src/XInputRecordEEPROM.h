@@ -0,0 +1,168 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputRecordEEPROM_h
+#define XInputRecordEEPROM_h
+
+#include <EEPROM.h>
+
+#include "XInputRecorder.h"
+
+#if XINPUT_RECORDER
+
+// --------------------------------------------------------
+// XInput Recording EEPROM Storage                        |
+// --------------------------------------------------------
+
+// Stores a recording in a region of the EEPROM, so it survives a reset.
+// The first two bytes of the region hold the length of the recording,
+// which is only written by flush() to save wear. Writes one byte per call
+// and only once the EEPROM is ready, so it never blocks the recorder.
+//
+// The incoming bytes are followed frame by frame, and the stored length
+// only ever covers whole frames. Once a frame doesn't fit it and every
+// frame after it are dropped (they're changes on the frame that was
+// lost), and the recording ends at the last frame that fit.
+//
+// Header-only so that sketches which don't use it don't depend on the
+// EEPROM library.
+class XInputRecordEEPROM : public XInputRecordSink, public XInputRecordSource {
+public:
+	XInputRecordEEPROM(uint16_t start, uint16_t size) :
+		start(start), size(size), readPos(0)
+	{
+		clear();
+	}
+
+	size_t write(const uint8_t * data, size_t length) override {
+		if (length == 0) return 0;
+
+		if (droppedFrames != 0) {  // Full, the rest of the recording is discarded
+			for (size_t i = 0; i < length; i++) {
+				if (endOfFrame(data[i])) droppedFrames++;
+			}
+			return length;
+		}
+
+		if (writePos < size - HeaderSize) {
+#ifdef __AVR__
+			if (!eeprom_is_ready()) return 0;  // Previous write still in progress
+#endif
+			EEPROM.update(start + HeaderSize + writePos, data[0]);
+			writePos++;
+		}
+		else {
+			frameLost = true;  // Out of room, this frame won't fit
+		}
+
+		if (endOfFrame(data[0])) {
+			if (frameLost) {
+				droppedFrames++;
+				writePos = frameEnd;  // Error: Full, the partial frame is discarded
+			}
+			frameEnd = writePos;
+		}
+		return 1;
+	}
+
+	void flush() override {
+		EEPROM.update(start, lowByte(frameEnd));
+		EEPROM.update(start + 1, highByte(frameEnd));
+	}
+
+	int read() override {
+		if (readPos >= length()) return -1;  // End of the recording
+		return EEPROM.read(start + HeaderSize + readPos++);
+	}
+
+	uint16_t length() const {
+		const uint16_t len = EEPROM.read(start) | (EEPROM.read(start + 1) << 8);
+		return len > size - HeaderSize ? 0 : len;  // Erased or invalid
+	}
+
+	uint32_t getDroppedFrames() const { return droppedFrames; }  // Frames lost with the EEPROM full
+	boolean overflowed() const { return droppedFrames != 0; }  // The recording was cut short
+
+	void rewind() { readPos = 0; }  // Play from the start
+	void clear() {  // Record over the stored recording
+		writePos = 0;
+		frameEnd = 0;
+		frameLost = false;
+		droppedFrames = 0;
+		field = TimeField;
+	}
+
+	static constexpr uint8_t HeaderSize = 2;
+
+private:
+	enum Field : uint8_t { TimeField, MaskField, DataField };
+
+	const uint16_t start;
+	const uint16_t size;
+	uint16_t writePos;
+	uint16_t readPos;
+
+	uint16_t frameEnd;  // End of the last whole frame stored
+	boolean frameLost;  // Part of the current frame didn't fit
+	uint32_t droppedFrames;
+
+	// Position in the current frame, see the recording format
+	Field field;
+	uint8_t shift;  // Of the next mask varint byte
+	uint32_t mask;
+	uint8_t dataLeft;
+
+	// Follows the frame format one byte at a time, returns 'true' on the
+	// frame's last byte
+	boolean endOfFrame(uint8_t b) {
+		switch (field) {
+		case TimeField:
+			if (b & 0x80) return false;  // More time bytes
+			field = MaskField;
+			shift = 0;
+			mask = 0;
+			return false;
+		case MaskField:
+			mask |= (uint32_t) (b & 0x7F) << shift;
+			shift += 7;
+			if (b & 0x80) return false;  // More mask bytes
+			dataLeft = 0;
+			for (; mask != 0; mask &= mask - 1) dataLeft++;  // One byte per bit
+			if (dataLeft == 0) break;
+			field = DataField;
+			return false;
+		case DataField:
+			if (--dataLeft != 0) return false;
+			break;
+		}
+		field = TimeField;
+		return true;
+	}
+};
+
+#endif  // XINPUT_RECORDER
+
+#endif
@@ -0,0 +1,276 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputRecorder.h"
+
+#if XINPUT_RECORDER
+
+constexpr uint8_t XInputRecorder::ReportStart;
+constexpr uint8_t XInputRecorder::ReportBytes;
+constexpr uint32_t XInputRecorder::KeyframeMask;
+constexpr uint8_t XInputRecorder::MaxFrameSize;
+
+// --------------------------------------------------------
+// XInput Recording Sinks and Sources                     |
+// --------------------------------------------------------
+
+size_t XInputRecordPrint::write(const uint8_t * data, size_t length) {
+	return output.write(data, length);
+}
+
+int XInputRecordStream::read() {
+	uint8_t b;
+	if (stream.readBytes(&b, 1) != 1) return -1;  // Timed out
+	return b;
+}
+
+// --------------------------------------------------------
+// XInput Recorder                                        |
+// --------------------------------------------------------
+
+XInputRecorder::XInputRecorder(uint8_t * buffer, uint16_t size) :
+	controller(nullptr), sink(nullptr), flushPending(false),
+	buffer(buffer), size(size), last(), frames(0), droppedFrames(0)
+{
+	clear();
+}
+
+void XInputRecorder::begin(XInputController& c) {
+	end();
+
+	controller = &c;
+	frames = 0;
+	droppedFrames = 0;
+	keyframe = true;
+	lastTime = micros();
+	record(c.getReport());  // Starting state
+
+	controller->setRecorder(this);
+}
+
+void XInputRecorder::end() {
+	if (controller == nullptr) return;  // Not recording
+
+	controller->setRecorder(nullptr);
+	controller = nullptr;
+	flushPending = true;
+}
+
+boolean XInputRecorder::recording() const {
+	return controller != nullptr;
+}
+
+void XInputRecorder::setSink(XInputRecordSink * s) {
+	sink = s;
+}
+
+void XInputRecorder::update() {
+	if (sink == nullptr) return;
+
+	while (used > 0) {
+		const uint16_t contiguous = (tail + used > size) ? size - tail : used;
+		const uint16_t written = sink->write(buffer + tail, contiguous);
+		if (written == 0) return;  // Sink busy, try again later
+
+		tail += written;
+		if (tail >= size) tail -= size;
+		used -= written;
+	}
+
+	if (flushPending) {
+		flushPending = false;
+		sink->flush();
+	}
+}
+
+uint16_t XInputRecorder::available() const {
+	return used;
+}
+
+void XInputRecorder::clear() {
+	head = 0;
+	tail = 0;
+	used = 0;
+	keyframe = true;  // Previous frames are gone
+}
+
+uint32_t XInputRecorder::getFrames() const {
+	return frames;
+}
+
+uint32_t XInputRecorder::getDroppedFrames() const {
+	return droppedFrames;
+}
+
+int XInputRecorder::read() {
+	if (used == 0) return -1;  // Empty
+
+	const uint8_t b = buffer[tail];
+	if (++tail >= size) tail = 0;
+	used--;
+	return b;
+}
+
+void XInputRecorder::record(const uint8_t * report) {
+	const uint32_t now = micros();
+
+	uint8_t frame[MaxFrameSize];
+	uint8_t * data = frame + MaxFrameSize - ReportBytes;  // Changed bytes, moved into place below
+	uint8_t numChanged = 0;
+
+	uint32_t mask = 0;
+	uint32_t bit = 1;
+	for (uint8_t i = ReportStart; i < sizeof(last); i++, bit <<= 1) {
+		if (keyframe || report[i] != last[i]) {
+			mask |= bit;
+			data[numChanged++] = report[i];
+		}
+	}
+	if (mask == 0) return;  // Nothing changed since the last frame
+
+	uint8_t length = putVarint(frame, now - lastTime);
+	length += putVarint(frame + length, mask);
+	memmove(frame + length, data, numChanged);
+	length += numChanged;
+
+	if (!push(frame, length)) {
+		droppedFrames++;
+		keyframe = true;  // Resync once there's room
+		return;
+	}
+
+	memcpy(last, report, sizeof(last));
+	lastTime = now;
+	keyframe = false;
+	frames++;
+}
+
+boolean XInputRecorder::push(const uint8_t * data, uint8_t length) {
+	if (size - used < length) return false;  // Error: Not enough room
+
+	for (uint8_t i = 0; i < length; i++) {
+		buffer[head] = data[i];
+		if (++head >= size) head = 0;
+	}
+	used += length;
+	return true;
+}
+
+uint8_t XInputRecorder::putVarint(uint8_t * out, uint32_t val) {
+	uint8_t length = 0;
+	while (val >= 0x80) {
+		out[length++] = (val & 0x7F) | 0x80;
+		val >>= 7;
+	}
+	out[length++] = val;
+	return length;
+}
+
+// --------------------------------------------------------
+// XInput Player                                          |
+// --------------------------------------------------------
+
+XInputPlayer::XInputPlayer(XInputRecordSource& source) :
+	source(source), controller(nullptr), report(), hasPending(false), frames(0)
+{}
+
+void XInputPlayer::begin(XInputController& c) {
+	memcpy(report, c.getReport(), sizeof(report));
+	hasPending = false;
+	frames = 0;
+	frameTime = micros();
+	controller = &c;
+}
+
+void XInputPlayer::stop() {
+	controller = nullptr;
+}
+
+boolean XInputPlayer::playing() const {
+	return controller != nullptr;
+}
+
+void XInputPlayer::update() {
+	if (controller == nullptr) return;  // Not playing
+
+	// Apply every frame that's due, in case the loop fell behind
+	while (true) {
+		if (!hasPending) {
+			if (!readFrame()) {
+				stop();  // End of the recording
+				return;
+			}
+			hasPending = true;
+		}
+
+		if (micros() - frameTime < pendingDelta) return;  // Not due yet
+		frameTime += pendingDelta;  // From the schedule, so timing errors don't add up
+
+		uint8_t index = 0;
+		uint32_t bit = 1;
+		for (uint8_t i = XInputRecorder::ReportStart; i < sizeof(report); i++, bit <<= 1) {
+			if (pendingMask & bit) report[i] = pending[index++];
+		}
+		hasPending = false;
+		frames++;
+
+		controller->setReport(report);
+	}
+}
+
+uint32_t XInputPlayer::getFrames() const {
+	return frames;
+}
+
+boolean XInputPlayer::readFrame() {
+	if (!readVarint(pendingDelta)) return false;
+	if (!readVarint(pendingMask)) return false;
+	if (pendingMask & ~XInputRecorder::KeyframeMask) return false;  // Error: Not a valid frame
+
+	uint8_t index = 0;
+	for (uint32_t bit = 1; bit <= pendingMask; bit <<= 1) {
+		if (!(pendingMask & bit)) continue;
+
+		const int b = source.read();
+		if (b < 0) return false;  // Error: Truncated frame
+		pending[index++] = b;
+	}
+	return true;
+}
+
+boolean XInputPlayer::readVarint(uint32_t& val) {
+	val = 0;
+	for (uint8_t shift = 0; shift < 35; shift += 7) {
+		const int b = source.read();
+		if (b < 0) return false;  // End of data
+
+		val |= (uint32_t) (b & 0x7F) << shift;
+		if (!(b & 0x80)) return true;
+	}
+	return false;  // Error: Too long
+}
+
+#endif  // XINPUT_RECORDER
@@ -0,0 +1,175 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputRecorder_h
+#define XInputRecorder_h
+
+#include "XInput.h"
+
+#if XINPUT_RECORDER
+
+// --------------------------------------------------------
+// XInput Recording Format                                |
+// --------------------------------------------------------
+
+// Each recorded frame is:
+//
+//   Time since the previous frame, in microseconds (varint)
+//   Changed byte mask, bit 'n' for report byte 'n + 2' (varint)
+//   The changed bytes, in report order
+//
+// Varints are LEB128: 7 bits per byte, low bits first, with the high bit
+// set if more bytes follow. The first frame after XInputRecorder::begin(),
+// and the first after any dropped frame, has every mask bit set (a
+// keyframe) so playback always starts from a known state.
+
+// --------------------------------------------------------
+// XInput Recording Sinks and Sources                     |
+// --------------------------------------------------------
+
+class XInputRecordSink {
+public:
+	virtual size_t write(const uint8_t * data, size_t length) = 0;  // Returns # of bytes taken, may be fewer. Must not block
+	virtual void flush() {}  // Called once all recorded data has been written
+};
+
+class XInputRecordSource {
+public:
+	virtual int read() = 0;  // Next byte, or -1 at the end of the data
+};
+
+class XInputRecordPrint : public XInputRecordSink {
+public:
+	XInputRecordPrint(Print& output) : output(output) {}
+	size_t write(const uint8_t * data, size_t length) override;
+
+private:
+	Print & output;
+};
+
+class XInputRecordStream : public XInputRecordPrint, public XInputRecordSource {
+public:
+	XInputRecordStream(Stream& stream) : XInputRecordPrint(stream), stream(stream) {}
+	int read() override;  // Waits up to the stream's timeout for each byte
+
+private:
+	Stream & stream;
+};
+
+// --------------------------------------------------------
+// XInput Recorder                                        |
+// --------------------------------------------------------
+
+// Records the frames sent by a controller into a RAM ring buffer. The
+// buffer is drained to the sink (if any) by update(), so slow sinks like
+// EEPROM don't hold up send(). Without a sink the recorder is the
+// storage, and can be played back directly.
+class XInputRecorder : public XInputRecordSource {
+public:
+	XInputRecorder(uint8_t * buffer, uint16_t size);
+
+	void begin(XInputController& controller=XInput);  // Start recording, from the controller's current state
+	void end();  // Stop recording
+	boolean recording() const;
+
+	void setSink(XInputRecordSink * sink);
+	void update();  // Drains the buffer to the sink, call once per loop
+
+	uint16_t available() const;  // Bytes in the buffer
+	void clear();
+
+	uint32_t getFrames() const;  // Frames recorded
+	uint32_t getDroppedFrames() const;  // Frames lost with the buffer full
+
+	int read() override;  // Removes the next byte from the buffer
+
+	void record(const uint8_t * report);  // Called by the controller on every send
+
+	static constexpr uint8_t ReportStart = 2;  // First recorded report byte, skipping type and size
+	static constexpr uint8_t ReportBytes = 20 - ReportStart;
+	static constexpr uint32_t KeyframeMask = (1UL << ReportBytes) - 1;
+	static constexpr uint8_t MaxFrameSize = 5 + 3 + ReportBytes;  // Varint time, varint mask, data
+
+private:
+	XInputController * controller;  // Controller being recorded, nullptr if stopped
+	XInputRecordSink * sink;
+	boolean flushPending;  // Sink needs flush() once the buffer is empty
+
+	uint8_t * const buffer;
+	const uint16_t size;
+	uint16_t head;  // Next byte to write
+	uint16_t tail;  // Next byte to read
+	uint16_t used;
+
+	uint8_t last[20];  // Last recorded report
+	uint32_t lastTime;  // Time of the last recorded frame
+	boolean keyframe;  // Next frame records every byte
+	uint32_t frames;
+	uint32_t droppedFrames;
+
+	boolean push(const uint8_t * data, uint8_t length);  // All or nothing
+	static uint8_t putVarint(uint8_t * out, uint32_t val);
+};
+
+// --------------------------------------------------------
+// XInput Player                                          |
+// --------------------------------------------------------
+
+// Plays a recording back through a controller at its original timing.
+// The recorded reports are applied with setReport(), so they are sent
+// bit-exact regardless of the controller's ranges and processing.
+class XInputPlayer {
+public:
+	XInputPlayer(XInputRecordSource& source);
+
+	void begin(XInputController& controller=XInput);  // Start playing from the source's current position
+	void stop();
+	boolean playing() const;
+
+	void update();  // Applies frames that are due, call once per loop
+
+	uint32_t getFrames() const;  // Frames played
+
+private:
+	XInputRecordSource & source;
+	XInputController * controller;  // Controller being played to, nullptr if stopped
+
+	uint8_t report[20];  // Report as of the last applied frame
+	uint8_t pending[XInputRecorder::ReportBytes];  // Changed bytes of the next frame
+	uint32_t pendingMask;
+	uint32_t pendingDelta;
+	boolean hasPending;  // Next frame has been read
+
+	uint32_t frameTime;  // Scheduled time of the last applied frame
+	uint32_t frames;
+
+	boolean readFrame();  // Returns 'false' at the end of the data
+	boolean readVarint(uint32_t& val);
+};
+
+#endif  // XINPUT_RECORDER
+
+#endif
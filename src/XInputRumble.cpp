@@ -0,0 +1,270 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputRumble.h"
+
+#if XINPUT_RUMBLE
+
+// --------------------------------------------------------
+// XInput Rumble Timer                                    |
+// --------------------------------------------------------
+
+#if XINPUT_RUMBLE_TIMER
+static XInputRumble * XInputRumble_TimerOutputs[XInputController::MaxInterfaces] = {};
+
+static void XInputRumble_TimerTick() {
+	for (uint8_t i = 0; i < XInputController::MaxInterfaces; i++) {
+		XInputRumble * const output = XInputRumble_TimerOutputs[i];
+		if (output != nullptr) output->update();
+	}
+}
+
+#if defined(__AVR__)
+// Shares Timer0 with millis(). The compare B match fires once per timer
+// cycle (~1 kHz) whatever the compare value, so OCR0B is left as it is and
+// analogWrite() on the OC0B pin carries on working alongside it.
+ISR(TIMER0_COMPB_vect) {
+	XInputRumble_TimerTick();
+}
+
+static void XInputRumble_TimerStart() {
+	TIMSK0 |= _BV(OCIE0B);
+}
+#elif defined(TEENSYDUINO)
+static IntervalTimer XInputRumble_Timer;
+
+static void XInputRumble_TimerStart() {
+	XInputRumble_Timer.begin(XInputRumble_TimerTick, 1000);  // 1 kHz
+}
+#else
+	#error "XINPUT_RUMBLE_TIMER is not supported on this board. Set it to 0 to render rumble from update()."
+#endif
+
+static void XInputRumble_TimerAttach(XInputRumble * output) {
+	for (uint8_t i = 0; i < XInputController::MaxInterfaces; i++) {
+		if (XInputRumble_TimerOutputs[i] == output) return;  // Already attached
+	}
+	for (uint8_t i = 0; i < XInputController::MaxInterfaces; i++) {
+		if (XInputRumble_TimerOutputs[i] == nullptr) {
+			XInputRumble_TimerOutputs[i] = output;
+			XInputRumble_TimerStart();
+			return;
+		}
+	}
+}
+
+static void XInputRumble_TimerDetach(XInputRumble * output) {
+	for (uint8_t i = 0; i < XInputController::MaxInterfaces; i++) {
+		if (XInputRumble_TimerOutputs[i] == output) XInputRumble_TimerOutputs[i] = nullptr;
+	}
+}
+#endif
+
+// --------------------------------------------------------
+// XInput Rumble Motor                                    |
+// --------------------------------------------------------
+
+XInputRumbleMotor::XInputRumbleMotor() :
+	minimum(0), rampRate(0), kickLevel(0), kickTime(0)
+{
+	reset();
+}
+
+void XInputRumbleMotor::setMinimum(uint8_t min) {
+	minimum = min;
+}
+
+void XInputRumbleMotor::setRamp(uint8_t rate) {
+	rampRate = rate;
+}
+
+void XInputRumbleMotor::setKick(uint8_t lvl, uint8_t ms) {
+	kickLevel = lvl;
+	kickTime = ms;
+}
+
+void XInputRumbleMotor::setLevel(uint8_t lvl, uint32_t now) {
+	// Scale 1-255 to minimum-255, so every nonzero level turns the motor
+	const uint8_t scaled = (lvl == 0) ? 0 :
+		minimum + ((uint16_t) lvl * (255 - minimum) + 127) / 255;
+
+	if (scaled != 0 && output == 0) {  // Starting from a stop
+		lastTime = now;  // Ramp from here, not from the last update while stopped
+		rampCarry = 0;
+		if (level < (uint16_t) minimum << 8) level = (uint16_t) minimum << 8;  // Don't ramp through the dead band
+		if (kickTime != 0) {
+			kicking = true;
+			kickStart = now;
+		}
+	}
+	target = scaled;
+}
+
+uint8_t XInputRumbleMotor::update(uint32_t now) {
+	uint32_t elapsed = now - lastTime;
+	lastTime = now;
+	if (elapsed > 0xFFFF) elapsed = 0xFFFF;  // Keeps the ramp step in range
+
+	if (kicking) {
+		if (target != 0 && now - kickStart < (uint32_t) kickTime * 1000) {
+			output = kickLevel;
+			return output;
+		}
+		kicking = false;  // Done or stopped, carry on from the ramp level
+	}
+
+	const uint16_t goal = (uint16_t) target << 8;
+	if (rampRate == 0) {
+		level = goal;
+	}
+	else {
+		// 8.8 per µs elapsed. The fraction is carried over, so frequent
+		// updates (e.g. from the timer) don't lose the slow ramps
+		const uint32_t scaled = (uint32_t) rampRate * elapsed * 256 + rampCarry;
+		const uint32_t step = scaled / 1000;
+		rampCarry = (level == goal) ? 0 : scaled % 1000;
+		if (level < goal) level = ((uint16_t) (goal - level) > step) ? level + step : goal;
+		else if (level > goal) level = ((uint16_t) (level - goal) > step) ? level - step : goal;
+	}
+
+	if (target == 0 && (level >> 8) < minimum) level = 0;  // Motor has stopped, skip the dead band
+	output = level >> 8;
+	return output;
+}
+
+uint8_t XInputRumbleMotor::getOutput() const {
+	return output;
+}
+
+void XInputRumbleMotor::reset() {
+	target = 0;
+	level = 0;
+	rampCarry = 0;
+	output = 0;
+	kicking = false;
+	kickStart = 0;
+	lastTime = 0;
+}
+
+// --------------------------------------------------------
+// XInput Rumble Output                                   |
+// --------------------------------------------------------
+
+XInputRumble::XInputRumble(uint8_t pinLarge, uint8_t pinSmall) :
+	controller(nullptr), pins{ pinLarge, pinSmall }, levels(), applied(), written(), rendering(false)
+{}
+
+void XInputRumble::begin(XInputController& c) {
+	end();
+
+	for (uint8_t i = 0; i < 2; i++) {
+		pinMode(pins[i], OUTPUT);
+		motors[i].reset();
+		levels[i] = 0;
+		applied[i] = 0;
+		write(i, 0);
+	}
+
+	controller = &c;
+	setRumble(c.getRumbleLeft(), c.getRumbleRight());  // Pick up the current state
+	controller->setRumbleOutput(this);
+
+#if XINPUT_RUMBLE_TIMER
+	XInputRumble_TimerAttach(this);
+#endif
+}
+
+void XInputRumble::end() {
+	if (controller == nullptr) return;  // Not started
+
+	controller->setRumbleOutput(nullptr);
+	controller = nullptr;
+#if XINPUT_RUMBLE_TIMER
+	XInputRumble_TimerDetach(this);
+#endif
+
+	for (uint8_t i = 0; i < 2; i++) {
+		motors[i].reset();
+		write(i, 0);
+	}
+}
+
+void XInputRumble::setMinimum(uint8_t min) {
+	motors[0].setMinimum(min);
+	motors[1].setMinimum(min);
+}
+
+void XInputRumble::setRamp(uint8_t rate) {
+	motors[0].setRamp(rate);
+	motors[1].setRamp(rate);
+}
+
+void XInputRumble::setKick(uint8_t level, uint8_t ms) {
+	motors[0].setKick(level, ms);
+	motors[1].setKick(level, ms);
+}
+
+XInputRumbleMotor & XInputRumble::getLarge() {
+	return motors[0];
+}
+
+XInputRumbleMotor & XInputRumble::getSmall() {
+	return motors[1];
+}
+
+void XInputRumble::setRumble(uint8_t large, uint8_t small) {
+	levels[0] = large;
+	levels[1] = small;
+	update();  // Respond now, rather than on the next tick
+}
+
+void XInputRumble::update() {
+	// The timer, the receive ISR and the loop can all call this. A call
+	// that interrupts another is skipped, and the new levels are picked up
+	// by the next one.
+	if (rendering || controller == nullptr) return;
+	rendering = true;
+
+	const uint32_t now = micros();
+	for (uint8_t i = 0; i < 2; i++) {
+		const uint8_t lvl = levels[i];
+		if (lvl != applied[i]) {
+			applied[i] = lvl;
+			motors[i].setLevel(lvl, now);
+		}
+		const uint8_t out = motors[i].update(now);
+		if (out != written[i]) write(i, out);
+	}
+
+	rendering = false;
+}
+
+void XInputRumble::write(uint8_t index, uint8_t val) {
+	written[index] = val;
+	analogWrite(pins[index], val);
+}
+
+#endif  // XINPUT_RUMBLE
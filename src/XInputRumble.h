@@ -0,0 +1,114 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputRumble_h
+#define XInputRumble_h
+
+#include "XInput.h"
+
+#if XINPUT_RUMBLE
+
+// --------------------------------------------------------
+// XInput Rumble Motor                                    |
+// --------------------------------------------------------
+
+// Shapes one motor's PWM output from the received rumble level. Nonzero
+// levels are scaled up from the motor's minimum start level, changes can
+// be ramped, and a motor starting from a stop can be given a short
+// kick-start pulse. Times are passed in (microseconds), so the output is
+// the same whether it's rendered from a timer, the loop, or a test.
+class XInputRumbleMotor {
+public:
+	XInputRumbleMotor();
+
+	void setMinimum(uint8_t min);  // Lowest output that turns the motor
+	void setRamp(uint8_t rate);  // Max output change per ms, 0 for instant
+	void setKick(uint8_t level, uint8_t ms);  // Pulse when starting from a stop, 0 ms to disable
+
+	void setLevel(uint8_t level, uint32_t now);  // Received rumble level, 0-255
+	uint8_t update(uint32_t now);  // Renders and returns the output for 'now'
+	uint8_t getOutput() const;  // Last rendered output
+
+	void reset();  // Stops the motor, keeps the settings
+
+private:
+	uint8_t minimum;
+	uint8_t rampRate;
+	uint8_t kickLevel;
+	uint8_t kickTime;  // ms
+
+	uint8_t target;  // Scaled from the received level
+	uint16_t level;  // Ramped output, 8.8 fixed point
+	uint16_t rampCarry;  // Ramp step left over from the last update(), 1/1000 of the level's LSB
+	uint8_t output;
+	boolean kicking;
+	uint32_t kickStart;  // Time of the start of the kick
+	uint32_t lastTime;  // Time of the last update()
+};
+
+// --------------------------------------------------------
+// XInput Rumble Output                                   |
+// --------------------------------------------------------
+
+// Drives the large and small rumble motors from PWM pins. Received rumble
+// packets are passed straight from the controller's receive path, and
+// the outputs are rendered by update(): from the controller's update()
+// and on every rumble packet, or from a ~1 kHz hardware timer if
+// XINPUT_RUMBLE_TIMER is set. Either way the motors respond to the host
+// without waiting on the sketch's loop.
+class XInputRumble {
+public:
+	XInputRumble(uint8_t pinLarge, uint8_t pinSmall);
+
+	void begin(XInputController& controller=XInput);  // Attach to the controller and start driving the pins
+	void end();  // Detach and stop both motors
+
+	// Settings for both motors, see XInputRumbleMotor
+	void setMinimum(uint8_t min);
+	void setRamp(uint8_t rate);
+	void setKick(uint8_t level, uint8_t ms);
+
+	XInputRumbleMotor & getLarge();  // Large motor, left grip
+	XInputRumbleMotor & getSmall();  // Small motor, right grip
+
+	void setRumble(uint8_t large, uint8_t small);  // Called by the controller on every rumble packet
+	void update();  // Renders the outputs, safe to call from an ISR
+
+private:
+	XInputController * controller;  // nullptr if not started
+	const uint8_t pins[2];
+	XInputRumbleMotor motors[2];
+	volatile uint8_t levels[2];  // Received levels
+	uint8_t applied[2];  // Levels passed to the motors
+	uint8_t written[2];  // Outputs written to the pins
+	volatile boolean rendering;  // update() is running, skip nested calls
+
+	void write(uint8_t index, uint8_t val);
+};
+
+#endif  // XINPUT_RUMBLE
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include "XInputScheduler.h"
+
+constexpr uint32_t XInputScheduler::MinInterval;
+constexpr uint32_t XInputScheduler::MaxInterval;
+constexpr uint8_t XInputScheduler::ProbePolls;
+
+XInputScheduler::XInputScheduler() {
+	reset();
+}
+
+void XInputScheduler::reset() {
+	lead = 0;
+	setInterval(4000);  // 4 ms, the 360 controller's endpoint interval
+	lastPoll = 0;
+	lastObserved = 0;
+	lastWindow = 0;
+	observed = false;
+	sampled = false;
+	probe();
+}
+
+void XInputScheduler::setInterval(uint32_t i) {
+	if (i < MinInterval) i = MinInterval;
+	if (i > MaxInterval) i = MaxInterval;
+	interval = i;
+	intervalFine = i << 4;
+	if (lead >= interval) lead = interval - 1;
+}
+
+void XInputScheduler::setLeadTime(uint32_t l) {
+	if (l >= interval) l = interval - 1;  // Window must end before the next opens
+	lead = l;
+}
+
+uint32_t XInputScheduler::getInterval() const {
+	return interval;
+}
+
+uint32_t XInputScheduler::getLeadTime() const {
+	return lead;
+}
+
+boolean XInputScheduler::synced() const {
+	return observed;
+}
+
+boolean XInputScheduler::probing() const {
+	return probesLeft != 0;
+}
+
+void XInputScheduler::probe() {
+	probeMin = MaxInterval;
+	probesLeft = ProbePolls;
+}
+
+void XInputScheduler::pollObserved(uint32_t time) {
+	if (observed) {
+		const uint32_t delta = time - lastObserved;
+
+		if (probesLeft != 0) {
+			// While probing the caller sends again as soon as the host reads,
+			// so each gap is one poll, or more if the host NAKed or the send
+			// was late. The shortest is the interval.
+			if (delta < probeMin) probeMin = delta;
+			if (--probesLeft == 0) setInterval(probeMin);
+		}
+		else if (delta < interval - interval / 4) {
+			probe();  // Polls are faster than the estimate, measure them again
+		}
+		else {
+			// Observations may skip polls (e.g. if there was nothing to send),
+			// so divide the gap by the number of whole intervals it spans
+			const uint32_t polls = (delta + interval / 2) / interval;
+
+			if (polls != 0 && polls <= 8) {
+				const int32_t error = (int32_t) ((delta << 4) / polls) - (int32_t) intervalFine;
+				intervalFine += error / 8;  // Smooth out jitter
+
+				uint32_t estimate = (intervalFine + 8) >> 4;
+				if (estimate < MinInterval) estimate = MinInterval;
+				if (estimate > MaxInterval) estimate = MaxInterval;
+				interval = estimate;
+				intervalFine = constrain(intervalFine, MinInterval << 4, MaxInterval << 4);
+				if (lead >= interval) lead = interval - 1;
+			}
+		}
+	}
+
+	lastObserved = time;
+	lastPoll = time;
+	observed = true;
+}
+
+void XInputScheduler::advance(uint32_t now) {
+	const uint32_t elapsed = now - lastPoll;
+	if ((int32_t) elapsed < (int32_t) interval) return;  // Also ignores polls observed 'after' now
+
+	lastPoll += (elapsed / interval) * interval;
+}
+
+uint32_t XInputScheduler::nextPoll(uint32_t now) {
+	advance(now);
+	return lastPoll + interval;
+}
+
+boolean XInputScheduler::samePoll(uint32_t a, uint32_t b) const {
+	const int32_t diff = a - b;
+	return abs(diff) < (int32_t) (interval / 2);
+}
+
+boolean XInputScheduler::sampleDue(uint32_t now) {
+	const uint32_t next = nextPoll(now);
+	if (sampled && samePoll(lastWindow, next)) return false;  // Already sampled for this poll
+
+	// Sample if the window before the next poll is open, or if the
+	// window for the last poll was missed (late data is better than
+	// none). Either way that's the one sample for this interval.
+	// Predictions are compared loosely, as observed polls jitter.
+	const boolean windowOpen = (int32_t) (now - (next - lead)) >= 0;
+	const boolean missedLast = !sampled || !samePoll(lastWindow, lastPoll);
+
+	if (!windowOpen && !missedLast) return false;
+
+	lastWindow = next;
+	sampled = true;
+	return true;
+}
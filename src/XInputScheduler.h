@@ -0,0 +1,80 @@
+/*
+ *  Project     Arduino XInput Library
+ *  @author     David Madison
+ *  @link       github.com/dmadison/ArduinoXInput
+ *  @license    MIT - Copyright (c) 2019 David Madison
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef XInputScheduler_h
+#define XInputScheduler_h
+
+#include <Arduino.h>
+
+// --------------------------------------------------------
+// XInput Host Poll Scheduler                             |
+// (Predicts host polls to time sampling and sends)       |
+// --------------------------------------------------------
+
+// All times are in microseconds and are passed in by the caller, so the
+// scheduler works with any clock source (micros(), a hardware timer, or
+// a simulated clock). Time comparisons are safe across overflow.
+
+class XInputScheduler {
+public:
+	XInputScheduler();
+
+	void reset();
+
+	void setInterval(uint32_t interval);  // Nominal host poll interval, replaced by the estimate once polls are observed
+	void setLeadTime(uint32_t lead);  // How long before the poll the sample window opens
+
+	uint32_t getInterval() const;  // Estimated host poll interval
+	uint32_t getLeadTime() const;
+	boolean synced() const;  // 'true' once a host poll has been observed
+	boolean probing() const;  // 'true' while measuring the interval, see pollObserved()
+	void probe();  // Measures the interval again
+
+	void pollObserved(uint32_t time);  // Host read a packet (or start of frame) at 'time'
+	boolean sampleDue(uint32_t now);  // 'true' once per poll interval, in the window before the predicted poll
+	uint32_t nextPoll(uint32_t now);  // Predicted time of the next host poll
+
+	static constexpr uint32_t MinInterval = 125;  // High speed microframe
+	static constexpr uint32_t MaxInterval = 255000;  // Longest USB interrupt interval
+	static constexpr uint8_t ProbePolls = 8;  // Back-to-back polls measured per probe
+
+private:
+	uint32_t interval;  // Estimated poll interval
+	uint32_t intervalFine;  // Estimated poll interval, 1/16 us
+	uint32_t lead;  // Sample lead time
+	uint32_t lastPoll;  // Time of the last observed or predicted poll
+	uint32_t lastObserved;  // Time of the last observed poll
+	uint32_t lastWindow;  // Predicted poll time of the last window sampled
+	uint32_t probeMin;  // Shortest gap seen while probing
+	uint8_t probesLeft;  // Polls left to measure, 0 once measured
+	boolean observed;  // A poll has been observed
+	boolean sampled;  // 'lastWindow' is valid
+
+	void advance(uint32_t now);  // Moves 'lastPoll' up to the most recent predicted poll
+	boolean samePoll(uint32_t a, uint32_t b) const;  // Times are within half an interval
+};
+
+#endif